@@ -0,0 +1,160 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+#ifndef _KeccakP_1600_SnP_h_
+#define _KeccakP_1600_SnP_h_
+
+/*
+This implementation compiles the generic 64-bit, AVX2 and AVX-512 implementations side by side,
+each with its own instruction-set flags, and selects the widest parallel permutations usable
+on the running processor the first time they are needed.
+The single-instance permutation is the generic 64-bit one, in whichever of its variants
+runs fastest on the processor, as timed the first time it is needed.
+All parallel implementations share the same lane-interleaved state layout,
+so the states declared by the callers fit whichever one is selected.
+*/
+
+#include <stddef.h>
+#include "brg_endian.h"
+
+#if (PLATFORM_BYTE_ORDER != IS_LITTLE_ENDIAN)
+#error Expecting a little-endian platform
+#endif
+
+#define KeccakP1600_isDispatched
+
+/** Sets of implementations the runtime dispatch can select from, from narrowest to widest. */
+typedef enum {
+    KeccakP1600_dispatchGeneric64,  /* no parallel permutations */
+    KeccakP1600_dispatchSSSE3,      /* SSSE3 ×2, e.g., on virtual machines that hide AVX */
+    KeccakP1600_dispatchAVX2,       /* SSSE3 ×2 and AVX2 ×4 */
+    KeccakP1600_dispatchAVX512      /* AVX-512 ×2, ×4 and ×8 */
+} KeccakP1600_DispatchLevel;
+
+/** Returns the widest set of implementations the processor and operating system support. */
+KeccakP1600_DispatchLevel KeccakP1600_GetSupportedDispatchLevel(void);
+
+/**
+  * Restricts the runtime dispatch to the given set of implementations, e.g., for testing.
+  * It must not be called while other threads use the parallel permutations.
+  * @return 0 if successful, 1 if the processor does not support @a level.
+  */
+int KeccakP1600_SetDispatchLevel(KeccakP1600_DispatchLevel level);
+
+/** Variants of the generic 64-bit single-instance permutation, as listed in Optimized64/KeccakP-1600-config.h. */
+typedef enum {
+    KeccakP1600_variantUnrolled,            /* all rounds unrolled */
+    KeccakP1600_variantUnrolled6,           /* 6 rounds unrolled */
+    KeccakP1600_variantComplementing6,      /* lane complementing, 6 rounds unrolled */
+    KeccakP1600_variantComplementing,       /* lane complementing, all rounds unrolled */
+    KeccakP1600_variantComplementingSHLD,   /* lane complementing, all rounds unrolled, using SHLD for rotations */
+    KeccakP1600_variantCount
+} KeccakP1600_Variant;
+
+/** Returns the variant of the single-instance permutation in use, timing them all first if none is chosen yet. */
+KeccakP1600_Variant KeccakP1600_GetVariant(void);
+
+/**
+  * Forces the variant of the single-instance permutation, e.g., for testing.
+  * The variants with lane complementing do not represent the state as the others do,
+  * so no single-instance state may be in use across this call.
+  * @return 0 if successful, 1 if @a variant is not a valid one.
+  */
+int KeccakP1600_SetVariant(KeccakP1600_Variant variant);
+
+#define KeccakP1600_implementation      KeccakP1600_GetImplementation()
+#define KeccakP1600_stateSizeInBytes    200
+#define KeccakP1600_stateAlignment      8
+#define KeccakP1600_12rounds_FastLoop_supported
+
+const char * KeccakP1600_GetImplementation(void);
+#define KeccakP1600_StaticInitialize()
+void KeccakP1600_Initialize(void *state);
+#define KeccakP1600_AddByte(state, byte, offset) \
+    ((unsigned char*)(state))[(offset)] ^= (byte)
+void KeccakP1600_AddBytes(void *state, const unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600_Permute_12rounds(void *state);
+void KeccakP1600_ExtractBytes(const void *state, unsigned char *data, unsigned int offset, unsigned int length);
+size_t KeccakP1600_12rounds_FastLoop_Absorb(void *state, unsigned int laneCount, const unsigned char *data, size_t dataByteLen);
+
+/* The functions below must only be called when KeccakP1600timesN_IsAvailable() returns 1. */
+
+#define KeccakP1600times2_implementation        KeccakP1600times2_GetImplementation()
+#define KeccakP1600times2_statesSizeInBytes     400
+#define KeccakP1600times2_statesAlignment       64
+#define KeccakP1600times2_isDispatched
+#define KeccakP1600times2_12rounds_FastLoop_supported
+
+int KeccakP1600times2_IsAvailable(void);
+const char * KeccakP1600times2_GetImplementation(void);
+#define KeccakP1600times2_StaticInitialize()
+void KeccakP1600times2_InitializeAll(void *states);
+#define KeccakP1600times2_AddByte(states, instanceIndex, byte, offset) \
+    ((unsigned char*)(states))[(instanceIndex)*8 + ((offset)/8)*2*8 + (offset)%8] ^= (byte)
+void KeccakP1600times2_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times2_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+void KeccakP1600times2_PermuteAll_12rounds(void *states);
+void KeccakP1600times2_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+size_t KeccakP1600times2_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+
+#define KeccakP1600times4_implementation        KeccakP1600times4_GetImplementation()
+#define KeccakP1600times4_statesSizeInBytes     800
+#define KeccakP1600times4_statesAlignment       64
+#define KeccakP1600times4_isDispatched
+#define KeccakP1600times4_12rounds_FastLoop_supported
+#define KeccakP1600times4_12rounds_LeafCVs_supported
+
+int KeccakP1600times4_IsAvailable(void);
+const char * KeccakP1600times4_GetImplementation(void);
+#define KeccakP1600times4_StaticInitialize()
+void KeccakP1600times4_InitializeAll(void *states);
+#define KeccakP1600times4_AddByte(states, instanceIndex, byte, offset) \
+    ((unsigned char*)(states))[(instanceIndex)*8 + ((offset)/8)*4*8 + (offset)%8] ^= (byte)
+void KeccakP1600times4_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times4_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+void KeccakP1600times4_PermuteAll_12rounds(void *states);
+void KeccakP1600times4_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times4_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+size_t KeccakP1600times4_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+/* Hashes N consecutive KangarooTwelve leaves of 8192 bytes and writes their N chaining values of 32 bytes consecutively. */
+void KeccakP1600times4_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues);
+
+#define KeccakP1600times8_implementation        KeccakP1600times8_GetImplementation()
+#define KeccakP1600times8_statesSizeInBytes     1600
+#define KeccakP1600times8_statesAlignment       64
+#define KeccakP1600times8_isDispatched
+#define KeccakP1600times8_12rounds_FastLoop_supported
+#define KeccakP1600times8_12rounds_LeafCVs_supported
+#define KeccakP1600times8_12rounds_PartialLeafCVs_supported
+
+int KeccakP1600times8_IsAvailable(void);
+const char * KeccakP1600times8_GetImplementation(void);
+#define KeccakP1600times8_StaticInitialize()
+void KeccakP1600times8_InitializeAll(void *states);
+#define KeccakP1600times8_AddByte(states, instanceIndex, byte, offset) \
+    ((unsigned char*)(states))[(instanceIndex)*8 + ((offset)/8)*8*8 + (offset)%8] ^= (byte)
+void KeccakP1600times8_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times8_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+void KeccakP1600times8_PermuteAll_12rounds(void *states);
+void KeccakP1600times8_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times8_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+size_t KeccakP1600times8_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+/* Hashes N consecutive KangarooTwelve leaves of 8192 bytes and writes their N chaining values of 32 bytes consecutively. */
+void KeccakP1600times8_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues);
+/* Same as KeccakP1600times8_12rounds_LeafCVs() for 1 to 8 leaves, using masked instances. */
+void KeccakP1600times8_12rounds_PartialLeafCVs(const unsigned char *data, unsigned int leafCount, unsigned char *chainingValues);
+
+#endif
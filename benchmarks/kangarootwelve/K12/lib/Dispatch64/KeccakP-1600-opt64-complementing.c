@@ -0,0 +1,35 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+/*
+Generic 64-bit implementation of Keccak-p[1600] (lane complementing, all rounds unrolled),
+with its functions renamed so that it can be linked next to the other variants and selected at runtime.
+*/
+
+#define KeccakP1600_implementation_config "lane complementing, all rounds unrolled"
+#define KeccakP1600_fullUnrolling
+#define KeccakP1600_useLaneComplementing
+
+#define KeccakP1600_Initialize                   KeccakP1600_Complementing_Initialize
+#define KeccakP1600_AddBytesInLane               KeccakP1600_Complementing_AddBytesInLane
+#define KeccakP1600_AddLanes                     KeccakP1600_Complementing_AddLanes
+#define KeccakP1600_AddBytes                     KeccakP1600_Complementing_AddBytes
+#define KeccakP1600_Permute_12rounds             KeccakP1600_Complementing_Permute_12rounds
+#define KeccakP1600_ExtractBytesInLane           KeccakP1600_Complementing_ExtractBytesInLane
+#define KeccakP1600_ExtractLanes                 KeccakP1600_Complementing_ExtractLanes
+#define KeccakP1600_ExtractBytes                 KeccakP1600_Complementing_ExtractBytes
+#define KeccakP1600_12rounds_FastLoop_Absorb     KeccakP1600_Complementing_12rounds_FastLoop_Absorb
+
+#include "KeccakP-1600-opt64.c"
@@ -0,0 +1,352 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+#include <stddef.h>
+#include <x86intrin.h>
+#include "KeccakP-1600-SnP.h"
+
+#if !defined(__GNUC__) || !(defined(__x86_64__) || defined(__i386__))
+#error "The runtime dispatch relies on GCC-style CPU detection on x86"
+#endif
+
+typedef struct {
+    const char *implementation;
+    void (*InitializeAll)(void *states);
+    void (*AddBytes)(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length);
+    void (*AddLanesAll)(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+    void (*PermuteAll_12rounds)(void *states);
+    void (*ExtractBytes)(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
+    void (*ExtractLanesAll)(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+    size_t (*FastLoop_Absorb)(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+    void (*LeafCVs)(const unsigned char *data, unsigned char *chainingValues);
+    void (*PartialLeafCVs)(const unsigned char *data, unsigned int leafCount, unsigned char *chainingValues);
+} KeccakP1600timesN_Functions;
+
+#define declareImplementation(Parallelism, Suffix) \
+    void KeccakP1600times##Parallelism##_##Suffix##_InitializeAll(void *states); \
+    void KeccakP1600times##Parallelism##_##Suffix##_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length); \
+    void KeccakP1600times##Parallelism##_##Suffix##_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset); \
+    void KeccakP1600times##Parallelism##_##Suffix##_PermuteAll_12rounds(void *states); \
+    void KeccakP1600times##Parallelism##_##Suffix##_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length); \
+    void KeccakP1600times##Parallelism##_##Suffix##_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset); \
+    size_t KeccakP1600times##Parallelism##_##Suffix##_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+
+#define declareLeafCVs(Parallelism, Suffix) \
+    void KeccakP1600times##Parallelism##_##Suffix##_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues);
+
+#define declarePartialLeafCVs(Parallelism, Suffix) \
+    void KeccakP1600times##Parallelism##_##Suffix##_12rounds_PartialLeafCVs(const unsigned char *data, unsigned int leafCount, unsigned char *chainingValues);
+
+#define implementation(Parallelism, Suffix, FastLoop, LeafCVs, PartialLeafCVs, description) \
+    { \
+        description, \
+        KeccakP1600times##Parallelism##_##Suffix##_InitializeAll, \
+        KeccakP1600times##Parallelism##_##Suffix##_AddBytes, \
+        KeccakP1600times##Parallelism##_##Suffix##_AddLanesAll, \
+        KeccakP1600times##Parallelism##_##Suffix##_PermuteAll_12rounds, \
+        KeccakP1600times##Parallelism##_##Suffix##_ExtractBytes, \
+        KeccakP1600times##Parallelism##_##Suffix##_ExtractLanesAll, \
+        FastLoop, \
+        LeafCVs, \
+        PartialLeafCVs \
+    }
+
+declareImplementation(2, SSSE3)
+declareImplementation(4, AVX2)
+declareImplementation(2, AVX512)
+declareImplementation(4, AVX512)
+declareImplementation(8, AVX512)
+declareLeafCVs(4, AVX2)
+declareLeafCVs(4, AVX512)
+declareLeafCVs(8, AVX512)
+declarePartialLeafCVs(8, AVX512)
+
+/* The 128-bit SIMD implementation has no fast loop of its own, so it gets the generic one. */
+size_t KeccakP1600times2_SSSE3_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen)
+{
+    const unsigned char *dataStart = data;
+
+    while(dataByteLen >= (laneOffsetParallel + laneCount)*8) {
+        KeccakP1600times2_SSSE3_AddLanesAll(states, data, laneCount, laneOffsetParallel);
+        KeccakP1600times2_SSSE3_PermuteAll_12rounds(states);
+        data += laneOffsetSerial*8;
+        dataByteLen -= laneOffsetSerial*8;
+    }
+    return data - dataStart;
+}
+
+static const KeccakP1600timesN_Functions times2_SSSE3 = implementation(2, SSSE3, KeccakP1600times2_SSSE3_12rounds_FastLoop_Absorb, NULL, NULL, "128-bit SIMD implementation (SSSE3, 2 rounds unrolled)");
+static const KeccakP1600timesN_Functions times4_AVX2 = implementation(4, AVX2, KeccakP1600times4_AVX2_12rounds_FastLoop_Absorb, KeccakP1600times4_AVX2_12rounds_LeafCVs, NULL, "256-bit SIMD implementation (AVX2, 12 rounds unrolled)");
+static const KeccakP1600timesN_Functions times2_AVX512 = implementation(2, AVX512, KeccakP1600times2_AVX512_12rounds_FastLoop_Absorb, NULL, NULL, "512-bit SIMD implementation (AVX512, 12 rounds unrolled)");
+static const KeccakP1600timesN_Functions times4_AVX512 = implementation(4, AVX512, KeccakP1600times4_AVX512_12rounds_FastLoop_Absorb, KeccakP1600times4_AVX512_12rounds_LeafCVs, NULL, "512-bit SIMD implementation (AVX512, 12 rounds unrolled)");
+static const KeccakP1600timesN_Functions times8_AVX512 = implementation(8, AVX512, KeccakP1600times8_AVX512_12rounds_FastLoop_Absorb, KeccakP1600times8_AVX512_12rounds_LeafCVs, KeccakP1600times8_AVX512_12rounds_PartialLeafCVs, "512-bit SIMD implementation (AVX512, 12 rounds unrolled)");
+
+/* The parallel implementations of each level, in the order of KeccakP1600_DispatchLevel */
+typedef struct {
+    const KeccakP1600timesN_Functions *times2;
+    const KeccakP1600timesN_Functions *times4;
+    const KeccakP1600timesN_Functions *times8;
+} KeccakP1600timesN_Level;
+
+static const KeccakP1600timesN_Level levels[] = {
+    { NULL, NULL, NULL },
+    { &times2_SSSE3, NULL, NULL },
+    { &times2_SSSE3, &times4_AVX2, NULL },
+    { &times2_AVX512, &times4_AVX512, &times8_AVX512 }
+};
+
+/*
+The selection is made on first use and can be narrowed later by KeccakP1600_SetDispatchLevel().
+It is published as a single pointer, so that a thread never sees the pointers of two levels mixed.
+*/
+static const KeccakP1600timesN_Level *level = NULL;
+
+KeccakP1600_DispatchLevel KeccakP1600_GetSupportedDispatchLevel(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl"))
+        return KeccakP1600_dispatchAVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return KeccakP1600_dispatchAVX2;
+    if (__builtin_cpu_supports("ssse3"))
+        return KeccakP1600_dispatchSSSE3;
+    return KeccakP1600_dispatchGeneric64;
+}
+
+int KeccakP1600_SetDispatchLevel(KeccakP1600_DispatchLevel dispatchLevel)
+{
+    if (dispatchLevel > KeccakP1600_GetSupportedDispatchLevel())
+        return 1;
+    __atomic_store_n(&level, &levels[dispatchLevel], __ATOMIC_RELEASE);
+    return 0;
+}
+
+static const KeccakP1600timesN_Level * selectedLevel(void)
+{
+    const KeccakP1600timesN_Level *current = __atomic_load_n(&level, __ATOMIC_ACQUIRE);
+
+    if (current == NULL) {
+        const KeccakP1600timesN_Level *supported = &levels[KeccakP1600_GetSupportedDispatchLevel()];
+        /* A level set meanwhile by KeccakP1600_SetDispatchLevel() is kept */
+        if (__atomic_compare_exchange_n(&level, &current, supported, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            current = supported;
+    }
+    return current;
+}
+
+/* The permutations are only called after KeccakP1600timesN_IsAvailable(), which made the selection */
+#define dispatched(Parallelism) (__atomic_load_n(&level, __ATOMIC_ACQUIRE)->times##Parallelism)
+
+#define dispatchedImplementation(Parallelism) \
+    int KeccakP1600times##Parallelism##_IsAvailable(void) \
+    { \
+        return selectedLevel()->times##Parallelism != NULL; \
+    } \
+    \
+    const char * KeccakP1600times##Parallelism##_GetImplementation(void) \
+    { \
+        const KeccakP1600timesN_Functions *functions = selectedLevel()->times##Parallelism; \
+        return (functions != NULL) ? functions->implementation : "not used"; \
+    } \
+    \
+    void KeccakP1600times##Parallelism##_InitializeAll(void *states) \
+    { \
+        dispatched(Parallelism)->InitializeAll(states); \
+    } \
+    \
+    void KeccakP1600times##Parallelism##_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length) \
+    { \
+        dispatched(Parallelism)->AddBytes(states, instanceIndex, data, offset, length); \
+    } \
+    \
+    void KeccakP1600times##Parallelism##_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset) \
+    { \
+        dispatched(Parallelism)->AddLanesAll(states, data, laneCount, laneOffset); \
+    } \
+    \
+    void KeccakP1600times##Parallelism##_PermuteAll_12rounds(void *states) \
+    { \
+        dispatched(Parallelism)->PermuteAll_12rounds(states); \
+    } \
+    \
+    void KeccakP1600times##Parallelism##_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length) \
+    { \
+        dispatched(Parallelism)->ExtractBytes(states, instanceIndex, data, offset, length); \
+    } \
+    \
+    void KeccakP1600times##Parallelism##_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset) \
+    { \
+        dispatched(Parallelism)->ExtractLanesAll(states, data, laneCount, laneOffset); \
+    } \
+    \
+    size_t KeccakP1600times##Parallelism##_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen) \
+    { \
+        return dispatched(Parallelism)->FastLoop_Absorb(states, laneCount, laneOffsetParallel, laneOffsetSerial, data, dataByteLen); \
+    }
+
+#define dispatchedLeafCVs(Parallelism) \
+    void KeccakP1600times##Parallelism##_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues) \
+    { \
+        dispatched(Parallelism)->LeafCVs(data, chainingValues); \
+    }
+
+#define dispatchedPartialLeafCVs(Parallelism) \
+    void KeccakP1600times##Parallelism##_12rounds_PartialLeafCVs(const unsigned char *data, unsigned int leafCount, unsigned char *chainingValues) \
+    { \
+        dispatched(Parallelism)->PartialLeafCVs(data, leafCount, chainingValues); \
+    }
+
+dispatchedImplementation(2)
+dispatchedImplementation(4)
+dispatchedImplementation(8)
+dispatchedLeafCVs(4)
+dispatchedLeafCVs(8)
+dispatchedPartialLeafCVs(8)
+
+/* The single-instance permutation */
+
+typedef struct {
+    const char *implementation;
+    void (*Initialize)(void *state);
+    void (*AddBytes)(void *state, const unsigned char *data, unsigned int offset, unsigned int length);
+    void (*Permute_12rounds)(void *state);
+    void (*ExtractBytes)(const void *state, unsigned char *data, unsigned int offset, unsigned int length);
+    size_t (*FastLoop_Absorb)(void *state, unsigned int laneCount, const unsigned char *data, size_t dataByteLen);
+} KeccakP1600_Functions;
+
+#define declareVariant(Suffix) \
+    void KeccakP1600_##Suffix##_Initialize(void *state); \
+    void KeccakP1600_##Suffix##_AddBytes(void *state, const unsigned char *data, unsigned int offset, unsigned int length); \
+    void KeccakP1600_##Suffix##_Permute_12rounds(void *state); \
+    void KeccakP1600_##Suffix##_ExtractBytes(const void *state, unsigned char *data, unsigned int offset, unsigned int length); \
+    size_t KeccakP1600_##Suffix##_12rounds_FastLoop_Absorb(void *state, unsigned int laneCount, const unsigned char *data, size_t dataByteLen);
+
+#define variant(Suffix, description) \
+    { \
+        "generic 64-bit optimized implementation (" description ")", \
+        KeccakP1600_##Suffix##_Initialize, \
+        KeccakP1600_##Suffix##_AddBytes, \
+        KeccakP1600_##Suffix##_Permute_12rounds, \
+        KeccakP1600_##Suffix##_ExtractBytes, \
+        KeccakP1600_##Suffix##_12rounds_FastLoop_Absorb \
+    }
+
+declareVariant(Unrolled)
+declareVariant(Unrolled6)
+declareVariant(Complementing6)
+declareVariant(Complementing)
+declareVariant(ComplementingSHLD)
+
+/* In the order of KeccakP1600_Variant */
+static const KeccakP1600_Functions variants[KeccakP1600_variantCount] = {
+    variant(Unrolled, "all rounds unrolled"),
+    variant(Unrolled6, "6 rounds unrolled"),
+    variant(Complementing6, "lane complementing, 6 rounds unrolled"),
+    variant(Complementing, "lane complementing, all rounds unrolled"),
+    variant(ComplementingSHLD, "lane complementing, all rounds unrolled, using SHLD for rotations")
+};
+
+/*
+Unlike the parallel implementations, the variant is chosen once and then kept,
+as a state initialized by a variant with lane complementing only fits those.
+*/
+static const KeccakP1600_Functions *single = NULL;
+
+/* Cycles to absorb 8 blocks with the fast loop and to permute 8 more times */
+static unsigned long long timeVariant(const KeccakP1600_Functions *functions)
+{
+    static const unsigned char data[8*168];
+    unsigned long long state[25];
+    unsigned long long t;
+    unsigned int i;
+
+    t = __rdtsc();
+    functions->Initialize(state);
+    functions->FastLoop_Absorb(state, 21, data, sizeof(data));
+    for(i=0; i<8; i++)
+        functions->Permute_12rounds(state);
+    return __rdtsc() - t;
+}
+
+static const KeccakP1600_Functions * selectedVariant(void)
+{
+    const KeccakP1600_Functions *current = __atomic_load_n(&single, __ATOMIC_ACQUIRE);
+
+    if (current == NULL) {
+        unsigned long long best[KeccakP1600_variantCount];
+        unsigned int fastest = 0;
+        unsigned int i, r;
+
+        /* Best of 16 runs, taken in turns so that a busy moment does not weigh on a single variant */
+        for(i=0; i<KeccakP1600_variantCount; i++)
+            best[i] = ~0ULL;
+        for(r=0; r<16; r++)
+            for(i=0; i<KeccakP1600_variantCount; i++) {
+                unsigned long long time = timeVariant(&variants[i]);
+                if (time < best[i])
+                    best[i] = time;
+            }
+        for(i=1; i<KeccakP1600_variantCount; i++)
+            if (best[i] < best[fastest])
+                fastest = i;
+        /* Concurrent first uses may time the variants differently, the first choice stored is kept */
+        if (__atomic_compare_exchange_n(&single, &current, &variants[fastest], 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            current = &variants[fastest];
+    }
+    return current;
+}
+
+KeccakP1600_Variant KeccakP1600_GetVariant(void)
+{
+    return (KeccakP1600_Variant)(selectedVariant() - variants);
+}
+
+int KeccakP1600_SetVariant(KeccakP1600_Variant variant)
+{
+    if ((unsigned int)variant >= KeccakP1600_variantCount)
+        return 1;
+    __atomic_store_n(&single, &variants[variant], __ATOMIC_RELEASE);
+    return 0;
+}
+
+const char * KeccakP1600_GetImplementation(void)
+{
+    return selectedVariant()->implementation;
+}
+
+void KeccakP1600_Initialize(void *state)
+{
+    selectedVariant()->Initialize(state);
+}
+
+void KeccakP1600_AddBytes(void *state, const unsigned char *data, unsigned int offset, unsigned int length)
+{
+    selectedVariant()->AddBytes(state, data, offset, length);
+}
+
+void KeccakP1600_Permute_12rounds(void *state)
+{
+    selectedVariant()->Permute_12rounds(state);
+}
+
+void KeccakP1600_ExtractBytes(const void *state, unsigned char *data, unsigned int offset, unsigned int length)
+{
+    selectedVariant()->ExtractBytes(state, data, offset, length);
+}
+
+size_t KeccakP1600_12rounds_FastLoop_Absorb(void *state, unsigned int laneCount, const unsigned char *data, size_t dataByteLen)
+{
+    return selectedVariant()->FastLoop_Absorb(state, laneCount, data, dataByteLen);
+}
@@ -0,0 +1,35 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+/*
+256-bit SIMD implementation of Keccak-p[1600]x4, with its functions renamed
+so that it can be linked next to the other ones and selected at runtime.
+*/
+
+#define KeccakP1600times4_InitializeAll                  KeccakP1600times4_AVX2_InitializeAll
+#define KeccakP1600times4_AddBytes                       KeccakP1600times4_AVX2_AddBytes
+#define KeccakP1600times4_AddLanesAll                    KeccakP1600times4_AVX2_AddLanesAll
+#define KeccakP1600times4_PermuteAll_12rounds            KeccakP1600times4_AVX2_PermuteAll_12rounds
+#define KeccakP1600times4_ExtractBytes                   KeccakP1600times4_AVX2_ExtractBytes
+#define KeccakP1600times4_ExtractLanesAll                KeccakP1600times4_AVX2_ExtractLanesAll
+#define KeccakP1600times4_12rounds_FastLoop_Absorb       KeccakP1600times4_AVX2_12rounds_FastLoop_Absorb
+#define KeccakP1600times4_12rounds_LeafCVs              KeccakP1600times4_AVX2_12rounds_LeafCVs
+
+/* The configuration of OptimizedAVX2/KeccakP-1600-config.h, whose SnP header is left out in favor of this one */
+#define KeccakP1600times4_unrolling 12
+#define KeccakP1600times4_useAVX2
+
+#include "KeccakP-1600-SnP.h"
+#include "KeccakP-1600-times4-SIMD256.c"
@@ -0,0 +1,39 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+/*
+AVX-512 implementation of Keccak-p[1600]x8, with its functions renamed
+so that it can be linked next to the other ones and selected at runtime.
+*/
+
+#define KeccakP1600times8_InitializeAll                  KeccakP1600times8_AVX512_InitializeAll
+#define KeccakP1600times8_AddBytes                       KeccakP1600times8_AVX512_AddBytes
+#define KeccakP1600times8_AddLanesAll                    KeccakP1600times8_AVX512_AddLanesAll
+#define KeccakP1600times8_PermuteAll_12rounds            KeccakP1600times8_AVX512_PermuteAll_12rounds
+#define KeccakP1600times8_ExtractBytes                   KeccakP1600times8_AVX512_ExtractBytes
+#define KeccakP1600times8_ExtractLanesAll                KeccakP1600times8_AVX512_ExtractLanesAll
+#define KeccakP1600times8_12rounds_FastLoop_Absorb       KeccakP1600times8_AVX512_12rounds_FastLoop_Absorb
+#define KeccakP1600times8_12rounds_LeafCVs              KeccakP1600times8_AVX512_12rounds_LeafCVs
+#define KeccakP1600times8_12rounds_PartialLeafCVs       KeccakP1600times8_AVX512_12rounds_PartialLeafCVs
+
+/* The configuration of OptimizedAVX512/KeccakP-1600-config.h, whose SnP header is left out in favor of this one */
+#define KeccakP1600times8_fullUnrolling
+#define KeccakP1600times8_useAVX512
+#define KeccakP1600times8_useTransposedLoads
+#define KeccakP1600times8_useTransposedStores
+#define KeccakP1600times8_prefetchDistance 512
+
+#include "KeccakP-1600-SnP.h"
+#include "KeccakP-1600-times8-SIMD512.c"
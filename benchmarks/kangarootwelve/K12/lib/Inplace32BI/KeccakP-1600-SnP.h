@@ -19,6 +19,9 @@ Please refer to the XKCP for more details.
 #define KeccakP1600_implementation      "in-place 32-bit optimized implementation"
 #define KeccakP1600_stateSizeInBytes    200
 #define KeccakP1600_stateAlignment      8
+#define KeccakP1600_12rounds_FastLoop_supported
+
+#include <stddef.h>
 
 #define KeccakP1600_StaticInitialize()
 void KeccakP1600_Initialize(void *state);
@@ -26,5 +29,28 @@ void KeccakP1600_AddByte(void *state, unsigned char data, unsigned int offset);
 void KeccakP1600_AddBytes(void *state, const unsigned char *data, unsigned int offset, unsigned int length);
 void KeccakP1600_Permute_12rounds(void *state);
 void KeccakP1600_ExtractBytes(const void *state, unsigned char *data, unsigned int offset, unsigned int length);
+size_t KeccakP1600_12rounds_FastLoop_Absorb(void *state, unsigned int laneCount, const unsigned char *data, size_t dataByteLen);
+
+/*
+With -DKeccakP1600_interleavedTimes2, two states side by side, their rounds interleaved so that the
+leaves of KangarooTwelve are hashed in pairs. Whether this helps depends on the core and on the
+number of registers, so it is left to the user.
+*/
+#if defined(KeccakP1600_interleavedTimes2)
+#define KeccakP1600times2_implementation        "in-place 32-bit optimized implementation, 2 instances interleaved"
+#define KeccakP1600times2_statesSizeInBytes     400
+#define KeccakP1600times2_statesAlignment       8
+#define KeccakP1600times2_12rounds_FastLoop_supported
+
+#define KeccakP1600times2_StaticInitialize()
+void KeccakP1600times2_InitializeAll(void *states);
+void KeccakP1600times2_AddByte(void *states, unsigned int instanceIndex, unsigned char byte, unsigned int offset);
+void KeccakP1600times2_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times2_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+void KeccakP1600times2_PermuteAll_12rounds(void *states);
+void KeccakP1600times2_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+size_t KeccakP1600times2_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+#endif
 
 #endif
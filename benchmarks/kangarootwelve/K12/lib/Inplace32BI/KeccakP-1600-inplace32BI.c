@@ -865,6 +865,58 @@ static const UINT32 KeccakF1600RoundConstants_int2[2*24+1] =
         Aso1 =   Bo ^((~Bu)&  Ba ); \
         Asu1 =   Bu ^((~Ba)&  Be );
 
+/* Names of the half lanes of the state pointed to by stateAsHalfLanes, for the rounds above */
+#define Aba0 stateAsHalfLanes[ 0]
+#define Aba1 stateAsHalfLanes[ 1]
+#define Abe0 stateAsHalfLanes[ 2]
+#define Abe1 stateAsHalfLanes[ 3]
+#define Abi0 stateAsHalfLanes[ 4]
+#define Abi1 stateAsHalfLanes[ 5]
+#define Abo0 stateAsHalfLanes[ 6]
+#define Abo1 stateAsHalfLanes[ 7]
+#define Abu0 stateAsHalfLanes[ 8]
+#define Abu1 stateAsHalfLanes[ 9]
+#define Aga0 stateAsHalfLanes[10]
+#define Aga1 stateAsHalfLanes[11]
+#define Age0 stateAsHalfLanes[12]
+#define Age1 stateAsHalfLanes[13]
+#define Agi0 stateAsHalfLanes[14]
+#define Agi1 stateAsHalfLanes[15]
+#define Ago0 stateAsHalfLanes[16]
+#define Ago1 stateAsHalfLanes[17]
+#define Agu0 stateAsHalfLanes[18]
+#define Agu1 stateAsHalfLanes[19]
+#define Aka0 stateAsHalfLanes[20]
+#define Aka1 stateAsHalfLanes[21]
+#define Ake0 stateAsHalfLanes[22]
+#define Ake1 stateAsHalfLanes[23]
+#define Aki0 stateAsHalfLanes[24]
+#define Aki1 stateAsHalfLanes[25]
+#define Ako0 stateAsHalfLanes[26]
+#define Ako1 stateAsHalfLanes[27]
+#define Aku0 stateAsHalfLanes[28]
+#define Aku1 stateAsHalfLanes[29]
+#define Ama0 stateAsHalfLanes[30]
+#define Ama1 stateAsHalfLanes[31]
+#define Ame0 stateAsHalfLanes[32]
+#define Ame1 stateAsHalfLanes[33]
+#define Ami0 stateAsHalfLanes[34]
+#define Ami1 stateAsHalfLanes[35]
+#define Amo0 stateAsHalfLanes[36]
+#define Amo1 stateAsHalfLanes[37]
+#define Amu0 stateAsHalfLanes[38]
+#define Amu1 stateAsHalfLanes[39]
+#define Asa0 stateAsHalfLanes[40]
+#define Asa1 stateAsHalfLanes[41]
+#define Ase0 stateAsHalfLanes[42]
+#define Ase1 stateAsHalfLanes[43]
+#define Asi0 stateAsHalfLanes[44]
+#define Asi1 stateAsHalfLanes[45]
+#define Aso0 stateAsHalfLanes[46]
+#define Aso1 stateAsHalfLanes[47]
+#define Asu0 stateAsHalfLanes[48]
+#define Asu1 stateAsHalfLanes[49]
+
 void KeccakP1600_Permute_Nrounds(void *state, unsigned int nRounds)
 {
     UINT32 Da0, De0, Di0, Do0, Du0;
@@ -873,56 +925,6 @@ void KeccakP1600_Permute_Nrounds(void *state, unsigned int nRounds)
     UINT32 Cx, Cy, Cz, Cw;
     const UINT32 *pRoundConstants = KeccakF1600RoundConstants_int2+(24-nRounds)*2;
     UINT32 *stateAsHalfLanes = (UINT32*)state;
-    #define Aba0 stateAsHalfLanes[ 0]
-    #define Aba1 stateAsHalfLanes[ 1]
-    #define Abe0 stateAsHalfLanes[ 2]
-    #define Abe1 stateAsHalfLanes[ 3]
-    #define Abi0 stateAsHalfLanes[ 4]
-    #define Abi1 stateAsHalfLanes[ 5]
-    #define Abo0 stateAsHalfLanes[ 6]
-    #define Abo1 stateAsHalfLanes[ 7]
-    #define Abu0 stateAsHalfLanes[ 8]
-    #define Abu1 stateAsHalfLanes[ 9]
-    #define Aga0 stateAsHalfLanes[10]
-    #define Aga1 stateAsHalfLanes[11]
-    #define Age0 stateAsHalfLanes[12]
-    #define Age1 stateAsHalfLanes[13]
-    #define Agi0 stateAsHalfLanes[14]
-    #define Agi1 stateAsHalfLanes[15]
-    #define Ago0 stateAsHalfLanes[16]
-    #define Ago1 stateAsHalfLanes[17]
-    #define Agu0 stateAsHalfLanes[18]
-    #define Agu1 stateAsHalfLanes[19]
-    #define Aka0 stateAsHalfLanes[20]
-    #define Aka1 stateAsHalfLanes[21]
-    #define Ake0 stateAsHalfLanes[22]
-    #define Ake1 stateAsHalfLanes[23]
-    #define Aki0 stateAsHalfLanes[24]
-    #define Aki1 stateAsHalfLanes[25]
-    #define Ako0 stateAsHalfLanes[26]
-    #define Ako1 stateAsHalfLanes[27]
-    #define Aku0 stateAsHalfLanes[28]
-    #define Aku1 stateAsHalfLanes[29]
-    #define Ama0 stateAsHalfLanes[30]
-    #define Ama1 stateAsHalfLanes[31]
-    #define Ame0 stateAsHalfLanes[32]
-    #define Ame1 stateAsHalfLanes[33]
-    #define Ami0 stateAsHalfLanes[34]
-    #define Ami1 stateAsHalfLanes[35]
-    #define Amo0 stateAsHalfLanes[36]
-    #define Amo1 stateAsHalfLanes[37]
-    #define Amu0 stateAsHalfLanes[38]
-    #define Amu1 stateAsHalfLanes[39]
-    #define Asa0 stateAsHalfLanes[40]
-    #define Asa1 stateAsHalfLanes[41]
-    #define Ase0 stateAsHalfLanes[42]
-    #define Ase1 stateAsHalfLanes[43]
-    #define Asi0 stateAsHalfLanes[44]
-    #define Asi1 stateAsHalfLanes[45]
-    #define Aso0 stateAsHalfLanes[46]
-    #define Aso1 stateAsHalfLanes[47]
-    #define Asu0 stateAsHalfLanes[48]
-    #define Asu1 stateAsHalfLanes[49]
 
     nRounds &= 3;
     switch ( nRounds )
@@ -1000,57 +1002,6 @@ void KeccakP1600_Permute_Nrounds(void *state, unsigned int nRounds)
         nRounds = 0;
     }
     while ( *pRoundConstants != 0xFF );
-
-    #undef Aba0
-    #undef Aba1
-    #undef Abe0
-    #undef Abe1
-    #undef Abi0
-    #undef Abi1
-    #undef Abo0
-    #undef Abo1
-    #undef Abu0
-    #undef Abu1
-    #undef Aga0
-    #undef Aga1
-    #undef Age0
-    #undef Age1
-    #undef Agi0
-    #undef Agi1
-    #undef Ago0
-    #undef Ago1
-    #undef Agu0
-    #undef Agu1
-    #undef Aka0
-    #undef Aka1
-    #undef Ake0
-    #undef Ake1
-    #undef Aki0
-    #undef Aki1
-    #undef Ako0
-    #undef Ako1
-    #undef Aku0
-    #undef Aku1
-    #undef Ama0
-    #undef Ama1
-    #undef Ame0
-    #undef Ame1
-    #undef Ami0
-    #undef Ami1
-    #undef Amo0
-    #undef Amo1
-    #undef Amu0
-    #undef Amu1
-    #undef Asa0
-    #undef Asa1
-    #undef Ase0
-    #undef Ase1
-    #undef Asi0
-    #undef Asi1
-    #undef Aso0
-    #undef Aso1
-    #undef Asu0
-    #undef Asu1
 }
 
 /* ---------------------------------------------------------------- */
@@ -1059,3 +1010,156 @@ void KeccakP1600_Permute_12rounds(void *state)
 {
      KeccakP1600_Permute_Nrounds(state, 12);
 }
+
+/* ---------------------------------------------------------------- */
+
+size_t KeccakP1600_12rounds_FastLoop_Absorb(void *state, unsigned int laneCount, const unsigned char *data, size_t dataByteLen)
+{
+    size_t originalDataByteLen = dataByteLen;
+
+    /* The state stays in bit-interleaved form from one block to the next */
+    while(dataByteLen >= laneCount*8) {
+        KeccakP1600_AddLanes(state, data, laneCount);
+        KeccakP1600_Permute_Nrounds(state, 12);
+        data += laneCount*8;
+        dataByteLen -= laneCount*8;
+    }
+    return originalDataByteLen - dataByteLen;
+}
+
+/* ---------------------------------------------------------------- */
+
+#if defined(KeccakP1600_interleavedTimes2)
+
+#define stateSize   200
+
+void KeccakP1600times2_InitializeAll(void *states)
+{
+    memset(states, 0, 2*stateSize);
+}
+
+void KeccakP1600times2_AddByte(void *states, unsigned int instanceIndex, unsigned char byte, unsigned int offset)
+{
+    KeccakP1600_AddByte((UINT8*)states + instanceIndex*stateSize, byte, offset);
+}
+
+void KeccakP1600times2_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length)
+{
+    KeccakP1600_AddBytes((UINT8*)states + instanceIndex*stateSize, data, offset, length);
+}
+
+void KeccakP1600times2_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    KeccakP1600_AddLanes(states, data, laneCount);
+    KeccakP1600_AddLanes((UINT8*)states + stateSize, data + laneOffset*8, laneCount);
+}
+
+/* One round of one of the two instances, with its own temporaries, the half-lane names referring to that instance */
+#define KeccakRoundOf(state, index) \
+    { \
+        UINT32 Da0, De0, Di0, Do0, Du0; \
+        UINT32 Da1, De1, Di1, Do1, Du1; \
+        UINT32 Ba, Be, Bi, Bo, Bu; \
+        UINT32 Cx, Cy, Cz, Cw; \
+        const UINT32 *pRoundConstants = roundConstants; \
+        UINT32 *stateAsHalfLanes = (state); \
+        KeccakRound##index(); \
+    }
+
+#define KeccakRoundTimes2(index) \
+    KeccakRoundOf(stateX, index) \
+    KeccakRoundOf(stateY, index) \
+    roundConstants += 2;
+
+void KeccakP1600times2_PermuteAll_12rounds(void *states)
+{
+    UINT32 *stateX = (UINT32*)states;
+    UINT32 *stateY = stateX + stateSize/4;
+    const UINT32 *roundConstants = KeccakF1600RoundConstants_int2+(24-12)*2;
+    unsigned int i;
+
+    /* 12 rounds keep the lanes at their places, as in KeccakP1600_Permute_Nrounds() */
+    for(i = 0; i < 12; i += 4) {
+        KeccakRoundTimes2(0)
+        KeccakRoundTimes2(1)
+        KeccakRoundTimes2(2)
+        KeccakRoundTimes2(3)
+    }
+}
+
+void KeccakP1600times2_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length)
+{
+    KeccakP1600_ExtractBytes((const UINT8*)states + instanceIndex*stateSize, data, offset, length);
+}
+
+void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    KeccakP1600_ExtractLanes(states, data, laneCount);
+    KeccakP1600_ExtractLanes((const UINT8*)states + stateSize, data + laneOffset*8, laneCount);
+}
+
+size_t KeccakP1600times2_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen)
+{
+    size_t originalDataByteLen = dataByteLen;
+
+    while(dataByteLen >= (laneOffsetParallel + laneCount)*8) {
+        KeccakP1600times2_AddLanesAll(states, data, laneCount, laneOffsetParallel);
+        KeccakP1600times2_PermuteAll_12rounds(states);
+        data += laneOffsetSerial*8;
+        dataByteLen -= laneOffsetSerial*8;
+    }
+    return originalDataByteLen - dataByteLen;
+}
+
+#endif
+
+#undef Aba0
+#undef Aba1
+#undef Abe0
+#undef Abe1
+#undef Abi0
+#undef Abi1
+#undef Abo0
+#undef Abo1
+#undef Abu0
+#undef Abu1
+#undef Aga0
+#undef Aga1
+#undef Age0
+#undef Age1
+#undef Agi0
+#undef Agi1
+#undef Ago0
+#undef Ago1
+#undef Agu0
+#undef Agu1
+#undef Aka0
+#undef Aka1
+#undef Ake0
+#undef Ake1
+#undef Aki0
+#undef Aki1
+#undef Ako0
+#undef Ako1
+#undef Aku0
+#undef Aku1
+#undef Ama0
+#undef Ama1
+#undef Ame0
+#undef Ame1
+#undef Ami0
+#undef Ami1
+#undef Amo0
+#undef Amo1
+#undef Amu0
+#undef Amu1
+#undef Asa0
+#undef Asa1
+#undef Ase0
+#undef Ase1
+#undef Asi0
+#undef Asi1
+#undef Aso0
+#undef Aso1
+#undef Asu0
+#undef Asu1
@@ -9,6 +9,8 @@ and related or neighboring rights to the source code in this file.
 http://creativecommons.org/publicdomain/zero/1.0/
 */
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include "KangarooTwelve.h"
 
@@ -167,10 +169,18 @@ int KeccakWidth1600_12rounds_SpongeSqueeze(KeccakWidth1600_12rounds_SpongeInstan
 #define rateInBytes     (rate/8)
 #define rateInLanes     (rateInBytes/laneSize)
 
+#define leavesPerBatch  8 /* Number of leaves processed between two absorptions in the final node */
+#if defined(KeccakP1600times16_implementation) && !defined(KeccakP1600times16_isFallback)
+#define leavesPerAbsorb 16 /* Same for KangarooTwelve_AbsorbLeaves(), at least the widest parallelism */
+#else
+#define leavesPerAbsorb leavesPerBatch
+#endif
+#define leavesPerJob    64 /* Number of leaves processed per job of KangarooTwelve_UpdateParallel() */
+#define jobsPerRound    64 /* Number of jobs given at once to the thread pool */
+
 #define ParallelSpongeFastLoop( Parallellism ) \
-    while ( inLen >= Parallellism * chunkSize ) { \
+    while ( leafCount >= Parallellism ) { \
         ALIGN(KeccakP1600times##Parallellism##_statesAlignment) unsigned char states[KeccakP1600times##Parallellism##_statesSizeInBytes]; \
-        unsigned char intermediate[Parallellism*capacityInBytes]; \
         unsigned int localBlockLen = chunkSize; \
         const unsigned char * localInput = input; \
         unsigned int i; \
@@ -188,16 +198,14 @@ int KeccakWidth1600_12rounds_SpongeSqueeze(KeccakWidth1600_12rounds_SpongeInstan
         } \
         KeccakP1600times##Parallellism##_PermuteAll_12rounds(states); \
         input += Parallellism * chunkSize; \
-        inLen -= Parallellism * chunkSize; \
-        ktInstance->blockNumber += Parallellism; \
-        KeccakP1600times##Parallellism##_ExtractLanesAll(states, intermediate, capacityInLanes, capacityInLanes ); \
-        if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, intermediate, Parallellism * capacityInBytes) != 0) return 1; \
+        leafCount -= Parallellism; \
+        KeccakP1600times##Parallellism##_ExtractLanesAll(states, chainingValues, capacityInLanes, capacityInLanes ); \
+        chainingValues += Parallellism * capacityInBytes; \
     }
 
 #define ParallelSpongeLoop( Parallellism ) \
-    while ( inLen >= Parallellism * chunkSize ) { \
+    while ( leafCount >= Parallellism ) { \
         ALIGN(KeccakP1600times##Parallellism##_statesAlignment) unsigned char states[KeccakP1600times##Parallellism##_statesSizeInBytes]; \
-        unsigned char intermediate[Parallellism*capacityInBytes]; \
         unsigned int localBlockLen = chunkSize; \
         const unsigned char * localInput = input; \
         unsigned int i; \
@@ -217,11 +225,99 @@ int KeccakWidth1600_12rounds_SpongeSqueeze(KeccakWidth1600_12rounds_SpongeInstan
         } \
         KeccakP1600times##Parallellism##_PermuteAll_12rounds(states); \
         input += Parallellism * chunkSize; \
-        inLen -= Parallellism * chunkSize; \
-        ktInstance->blockNumber += Parallellism; \
-        KeccakP1600times##Parallellism##_ExtractLanesAll(states, intermediate, capacityInLanes, capacityInLanes ); \
-        if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, intermediate, Parallellism * capacityInBytes) != 0) return 1; \
+        leafCount -= Parallellism; \
+        KeccakP1600times##Parallellism##_ExtractLanesAll(states, chainingValues, capacityInLanes, capacityInLanes ); \
+        chainingValues += Parallellism * capacityInBytes; \
+    }
+
+#define ParallelLeafCVs( Parallellism ) \
+    while ( leafCount >= Parallellism ) { \
+        KeccakP1600times##Parallellism##_12rounds_LeafCVs(input, chainingValues); \
+        input += Parallellism * chunkSize; \
+        leafCount -= Parallellism; \
+        chainingValues += Parallellism * capacityInBytes; \
+    }
+
+/* Computes the chaining values of complete leaves, using the widest parallel implementation first */
+static int KangarooTwelve_ProcessLeaves(const unsigned char *input, size_t leafCount, unsigned char *chainingValues)
+{
+    #if defined(KeccakP1600times16_implementation) && !defined(KeccakP1600times16_isFallback)
+    #if defined(KeccakP1600times16_isDispatched)
+    if (KeccakP1600times16_IsAvailable())
+    #endif
+    #if defined(KeccakP1600times16_12rounds_FastLoop_supported)
+    ParallelSpongeFastLoop( 16 )
+    #else
+    ParallelSpongeLoop( 16 )
+    #endif
+    #endif
+
+    #if defined(KeccakP1600times8_implementation) && !defined(KeccakP1600times8_isFallback)
+    #if defined(KeccakP1600times8_isDispatched)
+    if (KeccakP1600times8_IsAvailable())
+    #endif
+    {
+        #if defined(KeccakP1600times8_12rounds_LeafCVs_supported)
+        ParallelLeafCVs( 8 )
+        #elif defined(KeccakP1600times8_12rounds_FastLoop_supported)
+        ParallelSpongeFastLoop( 8 )
+        #else
+        ParallelSpongeLoop( 8 )
+        #endif
+        #if defined(KeccakP1600times8_12rounds_PartialLeafCVs_supported)
+        /* 3, 5, 6 or 7 remaining leaves take one masked ×8 pass, while 1, 2 or 4 are faster on the narrower implementations */
+        if ((leafCount & (leafCount - 1)) != 0) {
+            KeccakP1600times8_12rounds_PartialLeafCVs(input, (unsigned int)leafCount, chainingValues);
+            input += leafCount*chunkSize;
+            chainingValues += leafCount*capacityInBytes;
+            leafCount = 0;
+        }
+        #endif
+    }
+    #endif
+
+    #if defined(KeccakP1600times4_implementation) && !defined(KeccakP1600times4_isFallback)
+    #if defined(KeccakP1600times4_isDispatched)
+    if (KeccakP1600times4_IsAvailable())
+    #endif
+    #if defined(KeccakP1600times4_12rounds_LeafCVs_supported)
+    ParallelLeafCVs( 4 )
+    #elif defined(KeccakP1600times4_12rounds_FastLoop_supported)
+    ParallelSpongeFastLoop( 4 )
+    #else
+    ParallelSpongeLoop( 4 )
+    #endif
+    #endif
+
+    #if defined(KeccakP1600times2_implementation) && !defined(KeccakP1600times2_isFallback)
+    #if defined(KeccakP1600times2_isDispatched)
+    if (KeccakP1600times2_IsAvailable())
+    #endif
+    #if defined(KeccakP1600times2_12rounds_LeafCVs_supported)
+    ParallelLeafCVs( 2 )
+    #elif defined(KeccakP1600times2_12rounds_FastLoop_supported)
+    ParallelSpongeFastLoop( 2 )
+    #else
+    ParallelSpongeLoop( 2 )
+    #endif
+    #endif
+
+    while ( leafCount > 0 ) {
+        KeccakWidth1600_12rounds_SpongeInstance leafNode;
+        if (KeccakWidth1600_12rounds_SpongeInitialize(&leafNode, rate, capacity) != 0)
+            return 1;
+        if (KeccakWidth1600_12rounds_SpongeAbsorb(&leafNode, input, chunkSize) != 0)
+            return 1;
+        if (KeccakWidth1600_12rounds_SpongeAbsorbLastFewBits(&leafNode, suffixLeaf) != 0)
+            return 1;
+        if (KeccakWidth1600_12rounds_SpongeSqueeze(&leafNode, chainingValues, capacityInBytes) != 0)
+            return 1;
+        input += chunkSize;
+        --leafCount;
+        chainingValues += capacityInBytes;
     }
+    return 0;
+}
 
 static unsigned int right_encode( unsigned char * encbuf, size_t value )
 {
@@ -242,9 +338,177 @@ int KangarooTwelve_Initialize(KangarooTwelve_Instance *ktInstance, size_t output
     ktInstance->queueAbsorbedLen = 0;
     ktInstance->blockNumber = 0;
     ktInstance->phase = ABSORBING;
+    ktInstance->stagingBuffer = NULL;
+    ktInstance->stagingLen = 0;
+    ktInstance->pendingCVsLen = 0;
+    ktInstance->chainingValueSink = NULL;
+    ktInstance->chainingValueSinkLen = 0;
     return KeccakWidth1600_12rounds_SpongeInitialize(&ktInstance->finalNode, rate, capacity);
 }
 
+int KangarooTwelve_InitializeBuffered(KangarooTwelve_Instance *ktInstance, size_t outputLen, unsigned char *stagingBuffer)
+{
+    if (stagingBuffer == NULL)
+        return 1;
+    if (KangarooTwelve_Initialize(ktInstance, outputLen) != 0)
+        return 1;
+    ktInstance->stagingBuffer = stagingBuffer;
+    return 0;
+}
+
+int KangarooTwelve_SetChainingValueSink(KangarooTwelve_Instance *ktInstance, unsigned char *chainingValues, size_t maxLeafCount)
+{
+    if ( (ktInstance->phase != ABSORBING) || (ktInstance->blockNumber != 0) || (chainingValues == NULL) )
+        return 1;
+    if ( maxLeafCount > ((size_t)-1) / capacityInBytes )
+        maxLeafCount = ((size_t)-1) / capacityInBytes;
+    ktInstance->chainingValueSink = chainingValues;
+    ktInstance->chainingValueSinkLen = maxLeafCount * capacityInBytes;
+    return 0;
+}
+
+size_t KangarooTwelve_LeafCount(size_t inputByteLen, size_t customByteLen)
+{
+    unsigned char encbuf[sizeof(size_t)+1];
+    size_t suffixLen = customByteLen + right_encode(encbuf, customByteLen);
+
+    /* Every chunk of M || C || right_encode(|C|) but the first one is a leaf */
+    if ( inputByteLen + suffixLen <= chunkSize )
+        return 0;
+    return (inputByteLen + suffixLen - 1) / chunkSize;
+}
+
+/*
+Absorbs chaining values in the final node a whole rate block at a time, so that the sponge takes them
+with its fast loop. The bytes that do not complete a block wait in pendingCVs.
+*/
+static int KangarooTwelve_AbsorbChainingValues(KangarooTwelve_Instance *ktInstance, const unsigned char *chainingValues, size_t len)
+{
+    if ( ktInstance->chainingValueSink != NULL ) {
+        if ( len > ktInstance->chainingValueSinkLen )
+            return 1;
+        memcpy(ktInstance->chainingValueSink, chainingValues, len);
+        ktInstance->chainingValueSink += len;
+        ktInstance->chainingValueSinkLen -= len;
+    }
+    if ( (ktInstance->pendingCVsLen != 0) || (ktInstance->finalNode.byteIOIndex != 0) ) {
+        /* Complete the current block first */
+        unsigned int gap = rateInBytes - ktInstance->finalNode.byteIOIndex - ktInstance->pendingCVsLen;
+        unsigned int partLen = (len < gap) ? (unsigned int)len : gap;
+        memcpy(ktInstance->pendingCVs + ktInstance->pendingCVsLen, chainingValues, partLen);
+        ktInstance->pendingCVsLen += partLen;
+        chainingValues += partLen;
+        len -= partLen;
+        if ( partLen < gap )
+            return 0;
+        if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, ktInstance->pendingCVs, ktInstance->pendingCVsLen) != 0)
+            return 1;
+        ktInstance->pendingCVsLen = 0;
+    }
+    if ( len >= rateInBytes ) {
+        size_t blocksLen = len - len % rateInBytes;
+        if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, chainingValues, blocksLen) != 0)
+            return 1;
+        chainingValues += blocksLen;
+        len -= blocksLen;
+    }
+    memcpy(ktInstance->pendingCVs, chainingValues, len);
+    ktInstance->pendingCVsLen = (unsigned int)len;
+    return 0;
+}
+
+/* Hashes the given complete leaves and absorbs their chaining values in the final node */
+static int KangarooTwelve_AbsorbLeaves(KangarooTwelve_Instance *ktInstance, const unsigned char *input, size_t leafCount)
+{
+    while ( leafCount > 0 ) {
+        unsigned char intermediate[leavesPerAbsorb*capacityInBytes];
+        size_t count = (leafCount < leavesPerAbsorb) ? leafCount : leavesPerAbsorb;
+        if (KangarooTwelve_ProcessLeaves(input, count, intermediate) != 0)
+            return 1;
+        input += count * chunkSize;
+        leafCount -= count;
+        ktInstance->blockNumber += count;
+        if (KangarooTwelve_AbsorbChainingValues(ktInstance, intermediate, count * capacityInBytes) != 0)
+            return 1;
+    }
+    return 0;
+}
+
+/* Gathers the leaves in the staging buffer, and hashes them when it is full */
+static int KangarooTwelve_Stage(KangarooTwelve_Instance *ktInstance, const unsigned char *input, size_t inLen)
+{
+    if ( ktInstance->stagingLen != 0 ) {
+        size_t len = (inLen < (KangarooTwelve_stagingBufferSize - ktInstance->stagingLen)) ? inLen : (KangarooTwelve_stagingBufferSize - ktInstance->stagingLen);
+        memcpy(ktInstance->stagingBuffer + ktInstance->stagingLen, input, len);
+        input += len;
+        inLen -= len;
+        ktInstance->stagingLen += len;
+        if ( ktInstance->stagingLen < KangarooTwelve_stagingBufferSize )
+            return 0;
+        ktInstance->stagingLen = 0;
+        if (KangarooTwelve_AbsorbLeaves(ktInstance, ktInstance->stagingBuffer, KangarooTwelve_stagingBufferSize / chunkSize) != 0)
+            return 1;
+    }
+
+    /* Whole groups of leaves are hashed without copying them */
+    if ( inLen >= KangarooTwelve_stagingBufferSize ) {
+        size_t len = inLen - inLen % KangarooTwelve_stagingBufferSize;
+        if (KangarooTwelve_AbsorbLeaves(ktInstance, input, len / chunkSize) != 0)
+            return 1;
+        input += len;
+        inLen -= len;
+    }
+
+    memcpy(ktInstance->stagingBuffer, input, inLen);
+    ktInstance->stagingLen = inLen;
+    return 0;
+}
+
+/* Hashes the complete leaves in the staging buffer and moves the incomplete one to the queue node */
+static int KangarooTwelve_FlushStaging(KangarooTwelve_Instance *ktInstance)
+{
+    const unsigned char *stagingBuffer = ktInstance->stagingBuffer;
+    size_t leafCount = ktInstance->stagingLen / chunkSize;
+    size_t len = ktInstance->stagingLen % chunkSize;
+
+    /* The staging buffer is not used any more */
+    ktInstance->stagingBuffer = NULL;
+    ktInstance->stagingLen = 0;
+    if (KangarooTwelve_AbsorbLeaves(ktInstance, stagingBuffer, leafCount) != 0)
+        return 1;
+    if ( len > 0 ) {
+        if (KeccakWidth1600_12rounds_SpongeInitialize(&ktInstance->queueNode, rate, capacity) != 0)
+            return 1;
+        if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->queueNode, stagingBuffer + leafCount * chunkSize, len) != 0)
+            return 1;
+        ktInstance->queueAbsorbedLen = (unsigned int)len;
+    }
+    return 0;
+}
+
+/* Pads the complete first block in the final node, which then takes the chaining values */
+static int KangarooTwelve_CloseFirstBlock(KangarooTwelve_Instance *ktInstance)
+{
+    const unsigned char padding = 0x03; /* '110^6': message hop, simple padding */
+
+    ktInstance->queueAbsorbedLen = 0;
+    ktInstance->blockNumber = 1;
+    if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, &padding, 1) != 0)
+        return 1;
+    ktInstance->finalNode.byteIOIndex = (ktInstance->finalNode.byteIOIndex + 7) & ~7; /* Zero padding up to 64 bits */
+    return 0;
+}
+
+int KangarooTwelve_SetStagingBuffer(KangarooTwelve_Instance *ktInstance, unsigned char *stagingBuffer)
+{
+    if (ktInstance->phase != ABSORBING)
+        return 1;
+    if ( (ktInstance->stagingBuffer != NULL) && (KangarooTwelve_FlushStaging(ktInstance) != 0) )
+        return 1;
+    ktInstance->stagingBuffer = stagingBuffer;
+    return 0;
+}
+
 int KangarooTwelve_Update(KangarooTwelve_Instance *ktInstance, const unsigned char *input, size_t inLen)
 {
     if (ktInstance->phase != ABSORBING)
@@ -260,12 +524,8 @@ int KangarooTwelve_Update(KangarooTwelve_Instance *ktInstance, const unsigned ch
         ktInstance->queueAbsorbedLen += len;
         if ( (ktInstance->queueAbsorbedLen == chunkSize) && (inLen != 0) ) {
             /* First block complete and more input data available, finalize it */
-            const unsigned char padding = 0x03; /* '110^6': message hop, simple padding */
-            ktInstance->queueAbsorbedLen = 0;
-            ktInstance->blockNumber = 1;
-            if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, &padding, 1) != 0)
+            if (KangarooTwelve_CloseFirstBlock(ktInstance) != 0)
                 return 1;
-            ktInstance->finalNode.byteIOIndex = (ktInstance->finalNode.byteIOIndex + 7) & ~7; /* Zero padding up to 64 bits */
         }
     }
     else if ( ktInstance->queueAbsorbedLen != 0 ) {
@@ -284,74 +544,125 @@ int KangarooTwelve_Update(KangarooTwelve_Instance *ktInstance, const unsigned ch
                 return 1;
             if (KeccakWidth1600_12rounds_SpongeSqueeze(&ktInstance->queueNode, intermediate, capacityInBytes) != 0)
                 return 1;
-            if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, intermediate, capacityInBytes) != 0)
+            if (KangarooTwelve_AbsorbChainingValues(ktInstance, intermediate, capacityInBytes) != 0)
                 return 1;
         }
     }
 
-    #if defined(KeccakP1600times8_implementation) && !defined(KeccakP1600times8_isFallback)
-    #if defined(KeccakP1600times8_12rounds_FastLoop_supported)
-    ParallelSpongeFastLoop( 8 )
-    #else
-    ParallelSpongeLoop( 8 )
-    #endif
-    #endif
-
-    #if defined(KeccakP1600times4_implementation) && !defined(KeccakP1600times4_isFallback)
-    #if defined(KeccakP1600times4_12rounds_FastLoop_supported)
-    ParallelSpongeFastLoop( 4 )
-    #else
-    ParallelSpongeLoop( 4 )
-    #endif
-    #endif
+    if ( (ktInstance->stagingBuffer != NULL) && (inLen > 0) ) {
+        /* Buffered mode, the leaves go through the staging buffer */
+        return KangarooTwelve_Stage(ktInstance, input, inLen);
+    }
 
-    #if defined(KeccakP1600times2_implementation) && !defined(KeccakP1600times2_isFallback)
-    #if defined(KeccakP1600times2_12rounds_FastLoop_supported)
-    ParallelSpongeFastLoop( 2 )
-    #else
-    ParallelSpongeLoop( 2 )
-    #endif
-    #endif
+    if ( inLen >= chunkSize ) {
+        size_t leafCount = inLen / chunkSize;
+        if (KangarooTwelve_AbsorbLeaves(ktInstance, input, leafCount) != 0)
+            return 1;
+        input += leafCount * chunkSize;
+        inLen -= leafCount * chunkSize;
+    }
 
-    while ( inLen > 0 ) {
-        unsigned int len = (inLen < chunkSize) ? inLen : chunkSize;
+    if ( inLen > 0 ) {
+        /* Incomplete leaf, keep it in the queue node */
         if (KeccakWidth1600_12rounds_SpongeInitialize(&ktInstance->queueNode, rate, capacity) != 0)
             return 1;
-        if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->queueNode, input, len) != 0)
+        if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->queueNode, input, inLen) != 0)
+            return 1;
+        ktInstance->queueAbsorbedLen = (unsigned int)inLen;
+    }
+
+    return 0;
+}
+
+typedef struct {
+    const unsigned char *input;
+    size_t leafCount;
+    unsigned char *chainingValues;
+    int error;
+} KangarooTwelve_ParallelJobs;
+
+static void KangarooTwelve_ProcessJob(void *context, size_t jobIndex)
+{
+    KangarooTwelve_ParallelJobs *jobs = (KangarooTwelve_ParallelJobs *)context;
+    size_t firstLeaf = jobIndex * leavesPerJob;
+    size_t leafCount = (jobs->leafCount - firstLeaf < leavesPerJob) ? (jobs->leafCount - firstLeaf) : leavesPerJob;
+
+    if (KangarooTwelve_ProcessLeaves(jobs->input + firstLeaf * chunkSize, leafCount, jobs->chainingValues + firstLeaf * capacityInBytes) != 0)
+        jobs->error = 1;
+}
+
+int KangarooTwelve_UpdateParallel(KangarooTwelve_Instance *ktInstance, const unsigned char *input, size_t inLen, const KangarooTwelve_ThreadPool *threadPool)
+{
+    KangarooTwelve_ParallelJobs jobs;
+    size_t leafCount;
+
+    if (ktInstance->phase != ABSORBING)
+        return 1;
+
+    if ( (ktInstance->blockNumber == 0) || (ktInstance->queueAbsorbedLen != 0) ) {
+        /* Serially complete the first block or the leaf in the queue, and one more leaf so that
+           the first block gets finalized and the rest of the input starts on a leaf boundary */
+        size_t len = chunkSize - ktInstance->queueAbsorbedLen + chunkSize;
+        if (inLen <= len)
+            return KangarooTwelve_Update(ktInstance, input, inLen);
+        if (KangarooTwelve_Update(ktInstance, input, len) != 0)
             return 1;
         input += len;
         inLen -= len;
-        if ( len == chunkSize ) {
-            unsigned char intermediate[capacityInBytes];
-            ++ktInstance->blockNumber;
-            if (KeccakWidth1600_12rounds_SpongeAbsorbLastFewBits(&ktInstance->queueNode, suffixLeaf) != 0)
-                return 1;
-            if (KeccakWidth1600_12rounds_SpongeSqueeze(&ktInstance->queueNode, intermediate, capacityInBytes) != 0)
-                return 1;
-            if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, intermediate, capacityInBytes) != 0)
+    }
+    if ( ktInstance->stagingLen != 0 ) {
+        /* Buffered mode, serially complete the group of leaves in the staging buffer */
+        size_t len = KangarooTwelve_stagingBufferSize - ktInstance->stagingLen;
+        if (inLen <= len)
+            return KangarooTwelve_Update(ktInstance, input, inLen);
+        if (KangarooTwelve_Update(ktInstance, input, len) != 0)
+            return 1;
+        input += len;
+        inLen -= len;
+    }
+
+    leafCount = inLen / chunkSize;
+    if ( leafCount > leavesPerJob ) {
+        size_t roundLeafCount = (leafCount < leavesPerJob * jobsPerRound) ? leafCount : (leavesPerJob * jobsPerRound);
+        jobs.chainingValues = (unsigned char *)malloc(roundLeafCount * capacityInBytes);
+        if (jobs.chainingValues == NULL)
+            return 1;
+        jobs.error = 0;
+        while ( leafCount > leavesPerJob ) {
+            size_t jobCount;
+            jobs.input = input;
+            jobs.leafCount = (leafCount < leavesPerJob * jobsPerRound) ? leafCount : (leavesPerJob * jobsPerRound);
+            jobCount = (jobs.leafCount + leavesPerJob - 1) / leavesPerJob;
+            if (threadPool != NULL)
+                threadPool->run(threadPool->context, KangarooTwelve_ProcessJob, &jobs, jobCount);
+            else {
+                size_t i;
+                for ( i = 0; i < jobCount; ++i )
+                    KangarooTwelve_ProcessJob(&jobs, i);
+            }
+            /* Absorb the chaining values in order */
+            if ( (jobs.error != 0)
+              || (KangarooTwelve_AbsorbChainingValues(ktInstance, jobs.chainingValues, jobs.leafCount * capacityInBytes) != 0) ) {
+                free(jobs.chainingValues);
                 return 1;
+            }
+            ktInstance->blockNumber += jobs.leafCount;
+            input += jobs.leafCount * chunkSize;
+            inLen -= jobs.leafCount * chunkSize;
+            leafCount -= jobs.leafCount;
         }
-        else
-            ktInstance->queueAbsorbedLen = len;
+        free(jobs.chainingValues);
     }
 
-    return 0;
+    return KangarooTwelve_Update(ktInstance, input, inLen);
 }
 
-int KangarooTwelve_Final(KangarooTwelve_Instance *ktInstance, unsigned char * output, const unsigned char * customization, size_t customLen)
+/* Completes the final node once all of M || C || right_encode(|C|) has been input */
+static int KangarooTwelve_FinalNode(KangarooTwelve_Instance *ktInstance, unsigned char * output)
 {
     unsigned char encbuf[sizeof(size_t)+1+2];
     unsigned char padding;
 
-    if (ktInstance->phase != ABSORBING)
-        return 1;
-
-    /* Absorb customization | right_encode(customLen) */
-    if ((customLen != 0) && (KangarooTwelve_Update(ktInstance, customization, customLen) != 0))
-        return 1;
-    if (KangarooTwelve_Update(ktInstance, encbuf, right_encode(encbuf, customLen)) != 0)
-        return 1;
-
     if ( ktInstance->blockNumber == 0 ) {
         /* Non complete first block in final node, pad it */
         padding = 0x07; /*  '11': message hop, final node */
@@ -367,9 +678,12 @@ int KangarooTwelve_Final(KangarooTwelve_Instance *ktInstance, unsigned char * ou
                 return 1;
             if (KeccakWidth1600_12rounds_SpongeSqueeze(&ktInstance->queueNode, intermediate, capacityInBytes) != 0)
                 return 1;
-            if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, intermediate, capacityInBytes) != 0)
+            if (KangarooTwelve_AbsorbChainingValues(ktInstance, intermediate, capacityInBytes) != 0)
                 return 1;
         }
+        if (KeccakWidth1600_12rounds_SpongeAbsorb(&ktInstance->finalNode, ktInstance->pendingCVs, ktInstance->pendingCVsLen) != 0)
+            return 1;
+        ktInstance->pendingCVsLen = 0;
         --ktInstance->blockNumber; /* Absorb right_encode(number of Chaining Values) || 0xFF || 0xFF */
         n = right_encode(encbuf, ktInstance->blockNumber);
         encbuf[n++] = 0xFF;
@@ -388,6 +702,23 @@ int KangarooTwelve_Final(KangarooTwelve_Instance *ktInstance, unsigned char * ou
     return 0;
 }
 
+int KangarooTwelve_Final(KangarooTwelve_Instance *ktInstance, unsigned char * output, const unsigned char * customization, size_t customLen)
+{
+    unsigned char encbuf[sizeof(size_t)+1];
+
+    if (ktInstance->phase != ABSORBING)
+        return 1;
+
+    /* Absorb customization | right_encode(customLen) */
+    if ((customLen != 0) && (KangarooTwelve_Update(ktInstance, customization, customLen) != 0))
+        return 1;
+    if (KangarooTwelve_Update(ktInstance, encbuf, right_encode(encbuf, customLen)) != 0)
+        return 1;
+    if ( (ktInstance->stagingBuffer != NULL) && (KangarooTwelve_FlushStaging(ktInstance) != 0) )
+        return 1;
+    return KangarooTwelve_FinalNode(ktInstance, output);
+}
+
 int KangarooTwelve_Squeeze(KangarooTwelve_Instance *ktInstance, unsigned char * output, size_t outputLen)
 {
     if (ktInstance->phase != SQUEEZING)
@@ -395,7 +726,316 @@ int KangarooTwelve_Squeeze(KangarooTwelve_Instance *ktInstance, unsigned char *
     return KeccakWidth1600_12rounds_SpongeSqueeze(&ktInstance->finalNode, output, outputLen);
 }
 
+/* ---------------------------------------------------------------- */
+
+/*
+Layout of the exported state, all integers in little-endian order:
+    "K12" and the format version (4 bytes), phase (1), fixedOutputLength (8), blockNumber (8),
+    queueAbsorbedLen (2), pendingCVsLen (1), finalNode and queueNode (202 each), pendingCVs (168).
+A node is its 200-byte state as given by KeccakP1600_ExtractBytes(), byteIOIndex (1) and squeezing (1),
+so that neither the alignment nor the lane representation of the permutation leak into it.
+*/
+#define exportVersion   1
+#define exportNodeSize  (KeccakP1600_stateSizeInBytes+2)
+
+static unsigned char * KangarooTwelve_ExportInteger(unsigned char *buffer, uint64_t value, unsigned int byteLen)
+{
+    unsigned int i;
+
+    for ( i = 0; i < byteLen; ++i )
+        buffer[i] = (unsigned char)(value >> (8*i));
+    return buffer + byteLen;
+}
+
+static const unsigned char * KangarooTwelve_ImportInteger(const unsigned char *buffer, uint64_t *value, unsigned int byteLen)
+{
+    unsigned int i;
+
+    *value = 0;
+    for ( i = 0; i < byteLen; ++i )
+        *value |= (uint64_t)buffer[i] << (8*i);
+    return buffer + byteLen;
+}
+
+static unsigned char * KangarooTwelve_ExportNode(unsigned char *buffer, const KeccakWidth1600_12rounds_SpongeInstance *node)
+{
+    KeccakP1600_ExtractBytes(node->state, buffer, 0, KeccakP1600_stateSizeInBytes);
+    buffer[KeccakP1600_stateSizeInBytes] = (unsigned char)node->byteIOIndex;
+    buffer[KeccakP1600_stateSizeInBytes+1] = (unsigned char)node->squeezing;
+    return buffer + exportNodeSize;
+}
+
+static const unsigned char * KangarooTwelve_ImportNode(const unsigned char *buffer, KeccakWidth1600_12rounds_SpongeInstance *node, int *error)
+{
+    if (KeccakWidth1600_12rounds_SpongeInitialize(node, rate, capacity) != 0)
+        *error = 1;
+    KeccakP1600_AddBytes(node->state, buffer, 0, KeccakP1600_stateSizeInBytes);
+    node->byteIOIndex = buffer[KeccakP1600_stateSizeInBytes];
+    node->squeezing = buffer[KeccakP1600_stateSizeInBytes+1];
+    if ( (node->byteIOIndex > rateInBytes) || (node->squeezing > 1) )
+        *error = 1;
+    return buffer + exportNodeSize;
+}
+
+int KangarooTwelve_Export(KangarooTwelve_Instance *ktInstance, unsigned char *buffer)
+{
+    if ( (ktInstance->phase != ABSORBING) && (ktInstance->phase != FINAL) && (ktInstance->phase != SQUEEZING) )
+        return 1;
+    if ( ktInstance->stagingBuffer != NULL ) {
+        /* The staged leaves are not exported, hash them now and keep the instance buffered */
+        unsigned char *stagingBuffer = ktInstance->stagingBuffer;
+        if (KangarooTwelve_FlushStaging(ktInstance) != 0)
+            return 1;
+        ktInstance->stagingBuffer = stagingBuffer;
+    }
+
+    memcpy(buffer, "K12", 3);
+    buffer[3] = exportVersion;
+    buffer = KangarooTwelve_ExportInteger(buffer + 4, ktInstance->phase, 1);
+    buffer = KangarooTwelve_ExportInteger(buffer, ktInstance->fixedOutputLength, 8);
+    buffer = KangarooTwelve_ExportInteger(buffer, ktInstance->blockNumber, 8);
+    buffer = KangarooTwelve_ExportInteger(buffer, ktInstance->queueAbsorbedLen, 2);
+    buffer = KangarooTwelve_ExportInteger(buffer, ktInstance->pendingCVsLen, 1);
+    buffer = KangarooTwelve_ExportNode(buffer, &ktInstance->finalNode);
+    if ( (ktInstance->blockNumber != 0) && (ktInstance->queueAbsorbedLen != 0) )
+        buffer = KangarooTwelve_ExportNode(buffer, &ktInstance->queueNode);
+    else {
+        /* The queue node is not in use */
+        memset(buffer, 0, exportNodeSize);
+        buffer += exportNodeSize;
+    }
+    memcpy(buffer, ktInstance->pendingCVs, ktInstance->pendingCVsLen);
+    memset(buffer + ktInstance->pendingCVsLen, 0, sizeof(ktInstance->pendingCVs) - ktInstance->pendingCVsLen);
+    return 0;
+}
+
+int KangarooTwelve_Import(const unsigned char *buffer, KangarooTwelve_Instance *ktInstance)
+{
+    uint64_t phase, fixedOutputLength, blockNumber, queueAbsorbedLen, pendingCVsLen;
+    int error = 0;
+
+    if ( (memcmp(buffer, "K12", 3) != 0) || (buffer[3] != exportVersion) )
+        return 1;
+    buffer = KangarooTwelve_ImportInteger(buffer + 4, &phase, 1);
+    buffer = KangarooTwelve_ImportInteger(buffer, &fixedOutputLength, 8);
+    buffer = KangarooTwelve_ImportInteger(buffer, &blockNumber, 8);
+    buffer = KangarooTwelve_ImportInteger(buffer, &queueAbsorbedLen, 2);
+    buffer = KangarooTwelve_ImportInteger(buffer, &pendingCVsLen, 1);
+    if ( ((phase != ABSORBING) && (phase != FINAL) && (phase != SQUEEZING))
+      || (fixedOutputLength != (size_t)fixedOutputLength) || (blockNumber != (size_t)blockNumber)
+      || (queueAbsorbedLen > chunkSize) || (pendingCVsLen >= rateInBytes) )
+        return 1;
+    /* Until the first chunk is closed, there are no chaining values; after, a complete leaf does not stay in the queue */
+    if ( ((blockNumber == 0) && (pendingCVsLen != 0)) || ((blockNumber != 0) && (queueAbsorbedLen == chunkSize)) )
+        return 1;
+
+    ktInstance->phase = (KangarooTwelve_Phases)phase;
+    ktInstance->fixedOutputLength = (size_t)fixedOutputLength;
+    ktInstance->blockNumber = (size_t)blockNumber;
+    ktInstance->queueAbsorbedLen = (unsigned int)queueAbsorbedLen;
+    ktInstance->pendingCVsLen = (unsigned int)pendingCVsLen;
+    ktInstance->stagingBuffer = NULL;
+    ktInstance->stagingLen = 0;
+    ktInstance->chainingValueSink = NULL;
+    ktInstance->chainingValueSinkLen = 0;
+    buffer = KangarooTwelve_ImportNode(buffer, &ktInstance->finalNode, &error);
+    buffer = KangarooTwelve_ImportNode(buffer, &ktInstance->queueNode, &error);
+    memcpy(ktInstance->pendingCVs, buffer, sizeof(ktInstance->pendingCVs));
+    /* The pending chaining values complete the current block of the final node, they cannot go past it */
+    if ( ktInstance->pendingCVsLen + ktInstance->finalNode.byteIOIndex > rateInBytes )
+        error = 1;
+    return error;
+}
+
+/* Absorbs the next part of a single node straight into the state, @a offset being the position in the current block */
+static void KangarooTwelve_SingleNodeAbsorb(void *state, unsigned int *offset, const unsigned char *data, size_t len)
+{
+    while ( len > 0 ) {
+        if ( (*offset == 0) && (len >= rateInBytes) ) {
+#ifdef KeccakP1600_12rounds_FastLoop_supported
+            size_t j = KeccakP1600_12rounds_FastLoop_Absorb(state, rateInLanes, data, len);
+            data += j;
+            len -= j;
+#else
+            KeccakP1600_AddBytes(state, data, 0, rateInBytes);
+            KeccakP1600_Permute_12rounds(state);
+            data += rateInBytes;
+            len -= rateInBytes;
+#endif
+        }
+        else {
+            unsigned int partLen = (len < rateInBytes - *offset) ? (unsigned int)len : (rateInBytes - *offset);
+            KeccakP1600_AddBytes(state, data, *offset, partLen);
+            data += partLen;
+            len -= partLen;
+            *offset += partLen;
+            if ( *offset == rateInBytes ) {
+                KeccakP1600_Permute_12rounds(state);
+                *offset = 0;
+            }
+        }
+    }
+}
+
+/* Hashes M || C || right_encode(|C|) when it fits in the final node, without the two sponges and the state machine of an instance */
+static int KangarooTwelve_SingleNode(const unsigned char *input, size_t inLen, unsigned char *output, size_t outLen,
+    const unsigned char *customization, size_t customLen, const unsigned char *encbuf, unsigned int encLen)
+{
+    ALIGN(KeccakP1600_stateAlignment) unsigned char state[KeccakP1600_stateSizeInBytes];
+    unsigned int offset = 0;
+
+    KeccakP1600_StaticInitialize();
+    KeccakP1600_Initialize(state);
+    KangarooTwelve_SingleNodeAbsorb(state, &offset, input, inLen);
+    KangarooTwelve_SingleNodeAbsorb(state, &offset, customization, customLen);
+    KangarooTwelve_SingleNodeAbsorb(state, &offset, encbuf, encLen);
+    KeccakP1600_AddByte(state, 0x07, offset); /* '11': message hop, final node */
+    KeccakP1600_AddByte(state, 0x80, rateInBytes-1);
+    KeccakP1600_Permute_12rounds(state);
+    while ( outLen > rateInBytes ) {
+        KeccakP1600_ExtractBytes(state, output, 0, rateInBytes);
+        KeccakP1600_Permute_12rounds(state);
+        output += rateInBytes;
+        outLen -= rateInBytes;
+    }
+    KeccakP1600_ExtractBytes(state, output, 0, (unsigned int)outLen);
+    return 0;
+}
+
 int KangarooTwelve( const unsigned char * input, size_t inLen, unsigned char * output, size_t outLen, const unsigned char * customization, size_t customLen )
+{
+    KangarooTwelve_Instance ktInstance;
+    unsigned char encbuf[sizeof(size_t)+1];
+    unsigned int encLen;
+
+    if (outLen == 0)
+        return 1;
+    encLen = right_encode(encbuf, customLen);
+    if ( (inLen <= chunkSize - encLen) && (customLen <= chunkSize - encLen - inLen) )
+        return KangarooTwelve_SingleNode(input, inLen, output, outLen, customization, customLen, encbuf, encLen);
+    if (KangarooTwelve_Initialize(&ktInstance, outLen) != 0)
+        return 1;
+    if (KangarooTwelve_Update(&ktInstance, input, inLen) != 0)
+        return 1;
+    return KangarooTwelve_Final(&ktInstance, output, customization, customLen);
+}
+
+/* ---------------------------------------------------------------- */
+
+/* Copies the chunk of M || suffix at the given offset, returning its length */
+static size_t KangarooTwelve_CopyChunk(const unsigned char *input, size_t inLen, const unsigned char *suffix, size_t suffixLen, size_t offset, unsigned char *chunk)
+{
+    size_t len = 0;
+
+    if ( offset < inLen ) {
+        len = (inLen - offset < chunkSize) ? (inLen - offset) : chunkSize;
+        memcpy(chunk, input + offset, len);
+        offset += len;
+    }
+    if ( len < chunkSize ) {
+        size_t suffixOffset = offset - inLen;
+        size_t partLen = (suffixLen - suffixOffset < chunkSize - len) ? (suffixLen - suffixOffset) : (chunkSize - len);
+        memcpy(chunk + len, suffix + suffixOffset, partLen);
+        len += partLen;
+    }
+    return len;
+}
+
+/* Hashes a single leaf, complete or not */
+static int KangarooTwelve_HashLeaf(const unsigned char *leaf, size_t len, unsigned char *chainingValue)
+{
+    KeccakWidth1600_12rounds_SpongeInstance queueNode;
+
+    if (KeccakWidth1600_12rounds_SpongeInitialize(&queueNode, rate, capacity) != 0)
+        return 1;
+    if (KeccakWidth1600_12rounds_SpongeAbsorb(&queueNode, leaf, len) != 0)
+        return 1;
+    if (KeccakWidth1600_12rounds_SpongeAbsorbLastFewBits(&queueNode, suffixLeaf) != 0)
+        return 1;
+    return KeccakWidth1600_12rounds_SpongeSqueeze(&queueNode, chainingValue, capacityInBytes);
+}
+
+/* Hashes the complete leaves gathered in @a leaves and puts their chaining values at their places */
+static int KangarooTwelve_RehashLeaves(const unsigned char *leaves, const size_t *leafIndexes, size_t leafCount, unsigned char *chainingValues)
+{
+    unsigned char intermediate[leavesPerBatch*capacityInBytes];
+    size_t i;
+
+    if (KangarooTwelve_ProcessLeaves(leaves, leafCount, intermediate) != 0)
+        return 1;
+    for ( i = 0; i < leafCount; ++i )
+        memcpy(chainingValues + (leafIndexes[i] - 1) * capacityInBytes, intermediate + i * capacityInBytes, capacityInBytes);
+    return 0;
+}
+
+int KangarooTwelve_Rehash(const unsigned char *input, size_t inLen, unsigned char *chainingValues, const size_t *changedChunks, size_t changedCount,
+                          unsigned char *output, size_t outLen, const unsigned char *customization, size_t customLen)
+{
+    KangarooTwelve_Instance ktInstance;
+    unsigned char *suffix;
+    unsigned char *leaves;
+    size_t leafIndexes[leavesPerBatch];
+    size_t suffixLen, leafCount, gathered = 0, i;
+    int error = 0;
+
+    if (outLen == 0)
+        return 1;
+    leafCount = KangarooTwelve_LeafCount(inLen, customLen);
+    for ( i = 0; i < changedCount; ++i )
+        if ( changedChunks[i] > leafCount )
+            return 1;
+    if ( leafCount == 0 )
+        return KangarooTwelve(input, inLen, output, outLen, customization, customLen);
+
+    suffix = (unsigned char *)malloc(customLen + sizeof(size_t) + 1 + leavesPerBatch * chunkSize);
+    if (suffix == NULL)
+        return 1;
+    if ( customLen != 0 )
+        memcpy(suffix, customization, customLen);
+    suffixLen = customLen + right_encode(suffix + customLen, customLen);
+    leaves = suffix + suffixLen;
+
+    /* Gather the changed complete leaves and hash them 8 at a time, the incomplete last one on its own */
+    for ( i = 0; (i < changedCount) && !error; ++i ) {
+        size_t len;
+        if ( changedChunks[i] == 0 )
+            continue; /* The first chunk is absorbed again in the final node anyway */
+        len = KangarooTwelve_CopyChunk(input, inLen, suffix, suffixLen, changedChunks[i] * chunkSize, leaves + gathered * chunkSize);
+        if ( len == chunkSize ) {
+            leafIndexes[gathered++] = changedChunks[i];
+            if ( gathered == leavesPerBatch ) {
+                if (KangarooTwelve_RehashLeaves(leaves, leafIndexes, gathered, chainingValues) != 0)
+                    error = 1;
+                gathered = 0;
+            }
+        }
+        else if (KangarooTwelve_HashLeaf(leaves + gathered * chunkSize, len, chainingValues + (changedChunks[i] - 1) * capacityInBytes) != 0)
+            error = 1;
+    }
+    if ( (gathered != 0) && !error && (KangarooTwelve_RehashLeaves(leaves, leafIndexes, gathered, chainingValues) != 0) )
+        error = 1;
+
+    /* Replay the final node: first chunk, then all the chaining values */
+    KangarooTwelve_CopyChunk(input, inLen, suffix, suffixLen, 0, leaves);
+    if ( error
+      || (KangarooTwelve_Initialize(&ktInstance, outLen) != 0)
+      || (KangarooTwelve_Update(&ktInstance, leaves, chunkSize) != 0) )
+        error = 1;
+    free(suffix);
+    if (error)
+        return 1;
+    if (KangarooTwelve_CloseFirstBlock(&ktInstance) != 0)
+        return 1;
+    if (KangarooTwelve_AbsorbChainingValues(&ktInstance, chainingValues, leafCount * capacityInBytes) != 0)
+        return 1;
+    ktInstance.blockNumber += leafCount;
+    return KangarooTwelve_FinalNode(&ktInstance, output);
+}
+
+/* ---------------------------------------------------------------- */
+
+int KangarooTwelve_EncodeOutboard(const unsigned char *input, size_t inLen, unsigned char *outboard,
+                                  unsigned char *output, size_t outLen, const unsigned char *customization, size_t customLen)
 {
     KangarooTwelve_Instance ktInstance;
 
@@ -403,7 +1043,330 @@ int KangarooTwelve( const unsigned char * input, size_t inLen, unsigned char * o
         return 1;
     if (KangarooTwelve_Initialize(&ktInstance, outLen) != 0)
         return 1;
+    if (KangarooTwelve_SetChainingValueSink(&ktInstance, outboard, KangarooTwelve_LeafCount(inLen, customLen)) != 0)
+        return 1;
     if (KangarooTwelve_Update(&ktInstance, input, inLen) != 0)
         return 1;
     return KangarooTwelve_Final(&ktInstance, output, customization, customLen);
 }
+
+/* Squeezes the output of an instance initialized with no fixed output length and compares it with the expected hash */
+static int KangarooTwelve_CompareOutput(KangarooTwelve_Instance *ktInstance, const unsigned char *hash, size_t hashLen)
+{
+    unsigned char output[rateInBytes];
+    int difference = 0;
+
+    while ( hashLen > 0 ) {
+        size_t len = (hashLen < rateInBytes) ? hashLen : rateInBytes;
+        if (KangarooTwelve_Squeeze(ktInstance, output, len) != 0)
+            return 1;
+        difference |= memcmp(output, hash, len);
+        hash += len;
+        hashLen -= len;
+    }
+    return (difference != 0) ? 1 : 0;
+}
+
+/* Checks the first chunk, which authenticates the outboard too */
+static int KangarooTwelve_VerifyFirstChunk(const KangarooTwelve_Verifier *verifier, const unsigned char *chunk)
+{
+    KangarooTwelve_Instance ktInstance;
+
+    if (KangarooTwelve_Initialize(&ktInstance, 0) != 0)
+        return 1;
+    if ( verifier->leafCount == 0 ) {
+        /* Single node, the chunk is the whole M || C || right_encode(|C|) */
+        if (KangarooTwelve_Update(&ktInstance, chunk, verifier->inputByteLen) != 0)
+            return 1;
+        if (KangarooTwelve_Final(&ktInstance, NULL, verifier->customization, verifier->customByteLen) != 0)
+            return 1;
+    }
+    else {
+        if (KangarooTwelve_Update(&ktInstance, chunk, chunkSize) != 0)
+            return 1;
+        if (KangarooTwelve_CloseFirstBlock(&ktInstance) != 0)
+            return 1;
+        if (KangarooTwelve_AbsorbChainingValues(&ktInstance, verifier->outboard, verifier->leafCount * capacityInBytes) != 0)
+            return 1;
+        ktInstance.blockNumber += verifier->leafCount;
+        if (KangarooTwelve_FinalNode(&ktInstance, NULL) != 0)
+            return 1;
+    }
+    return KangarooTwelve_CompareOutput(&ktInstance, verifier->hash, verifier->hashByteLen);
+}
+
+/* Checks the given chunks starting at the current position, all complete except possibly the last one of the message */
+static int KangarooTwelve_VerifyChunks(const KangarooTwelve_Verifier *verifier, const unsigned char *chunks, size_t count, size_t lastLen)
+{
+    size_t index = verifier->position / chunkSize;
+    unsigned char chainingValues[leavesPerBatch*capacityInBytes];
+
+    if ( index == 0 )
+        return KangarooTwelve_VerifyFirstChunk(verifier, chunks);
+    if ( lastLen < chunkSize ) {
+        if (KangarooTwelve_HashLeaf(chunks, lastLen, chainingValues) != 0)
+            return 1;
+    }
+    else if (KangarooTwelve_ProcessLeaves(chunks, count, chainingValues) != 0)
+        return 1;
+    return (memcmp(chainingValues, verifier->outboard + (index - 1) * capacityInBytes, count * capacityInBytes) != 0) ? 1 : 0;
+}
+
+/* Checks M || C || right_encode(|C|) chunk by chunk, taking the complete ones straight from the given data */
+static int KangarooTwelve_VerifierFeed(KangarooTwelve_Verifier *verifier, const unsigned char *data, size_t len)
+{
+    while ( len > 0 ) {
+        if ( (verifier->queueLen == 0) && (len >= chunkSize) ) {
+            size_t count = (verifier->position == 0) ? 1 : (len / chunkSize);
+            if ( count > leavesPerBatch )
+                count = leavesPerBatch;
+            if (KangarooTwelve_VerifyChunks(verifier, data, count, chunkSize) != 0)
+                return 1;
+            data += count * chunkSize;
+            len -= count * chunkSize;
+            verifier->position += count * chunkSize;
+        }
+        else {
+            unsigned int partLen = (len < (chunkSize - verifier->queueLen)) ? (unsigned int)len : (chunkSize - verifier->queueLen);
+            memcpy(verifier->queue + verifier->queueLen, data, partLen);
+            data += partLen;
+            len -= partLen;
+            verifier->queueLen += partLen;
+            if ( verifier->queueLen == chunkSize ) {
+                if (KangarooTwelve_VerifyChunks(verifier, verifier->queue, 1, chunkSize) != 0)
+                    return 1;
+                verifier->position += chunkSize;
+                verifier->queueLen = 0;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Appends C || right_encode(|C|) and checks the last chunk */
+static int KangarooTwelve_VerifierEnd(KangarooTwelve_Verifier *verifier)
+{
+    unsigned char encbuf[sizeof(size_t)+1];
+
+    if (KangarooTwelve_VerifierFeed(verifier, verifier->customization, verifier->customByteLen) != 0)
+        return 1;
+    if (KangarooTwelve_VerifierFeed(verifier, encbuf, right_encode(encbuf, verifier->customByteLen)) != 0)
+        return 1;
+    if ( verifier->queueLen != 0 ) {
+        if (KangarooTwelve_VerifyChunks(verifier, verifier->queue, 1, verifier->queueLen) != 0)
+            return 1;
+        verifier->position += verifier->queueLen;
+        verifier->queueLen = 0;
+    }
+    return 0;
+}
+
+int KangarooTwelve_VerifierInitialize(KangarooTwelve_Verifier *verifier, size_t inLen, const unsigned char *outboard,
+                                      const unsigned char *hash, size_t hashLen, const unsigned char *customization, size_t customLen)
+{
+    if (hashLen == 0)
+        return 1;
+    verifier->outboard = outboard;
+    verifier->hash = hash;
+    verifier->hashByteLen = hashLen;
+    verifier->customization = customization;
+    verifier->customByteLen = customLen;
+    verifier->inputByteLen = inLen;
+    verifier->leafCount = KangarooTwelve_LeafCount(inLen, customLen);
+    verifier->position = 0;
+    verifier->failed = 0;
+    verifier->queueLen = 0;
+    return 0;
+}
+
+int KangarooTwelve_VerifierUpdate(KangarooTwelve_Verifier *verifier, const unsigned char *input, size_t inLen)
+{
+    if ( verifier->failed || (verifier->position > verifier->inputByteLen) || (inLen > verifier->inputByteLen - verifier->position - verifier->queueLen) )
+        return 1;
+    if (KangarooTwelve_VerifierFeed(verifier, input, inLen) != 0)
+        verifier->failed = 1;
+    else if ( (verifier->position + verifier->queueLen == verifier->inputByteLen) && (KangarooTwelve_VerifierEnd(verifier) != 0) )
+        verifier->failed = 1;
+    return verifier->failed;
+}
+
+int KangarooTwelve_VerifierFinal(KangarooTwelve_Verifier *verifier)
+{
+    if ( verifier->failed )
+        return 1;
+    if ( (verifier->position == 0) && (verifier->queueLen == 0) && (verifier->inputByteLen == 0) && (KangarooTwelve_VerifierEnd(verifier) != 0) )
+        verifier->failed = 1;
+    return (verifier->failed || (verifier->position <= verifier->inputByteLen)) ? 1 : 0;
+}
+
+/* ---------------------------------------------------------------- */
+
+#define isSingleNode( index ) (inLens[index] <= chunkSize - suffixLen)
+
+#if (defined(KeccakP1600times8_implementation) && !defined(KeccakP1600times8_isFallback)) \
+ || (defined(KeccakP1600times4_implementation) && !defined(KeccakP1600times4_isFallback)) \
+ || (defined(KeccakP1600times2_implementation) && !defined(KeccakP1600times2_isFallback))
+
+/* Returns the block of M || suffix starting at the given offset, assembling it in @a block if it straddles both */
+static const unsigned char * KangarooTwelve_BatchBlock(const unsigned char *input, size_t inLen, const unsigned char *suffix, size_t offset, unsigned int blockLen, unsigned char *block)
+{
+    if ( offset + blockLen <= inLen )
+        return input + offset;
+    if ( offset >= inLen )
+        return suffix + (offset - inLen);
+    memcpy(block, input + offset, inLen - offset);
+    memcpy(block + (inLen - offset), suffix, blockLen - (inLen - offset));
+    return block;
+}
+
+/* Squeezes the output of a single node from a state extracted from a parallel implementation */
+static int KangarooTwelve_BatchSqueeze(const unsigned char *stateBytes, unsigned char *output, size_t outLen)
+{
+    KeccakWidth1600_12rounds_SpongeInstance finalNode;
+
+    if (KeccakWidth1600_12rounds_SpongeInitialize(&finalNode, rate, capacity) != 0)
+        return 1;
+    KeccakP1600_AddBytes(finalNode.state, stateBytes, 0, KeccakP1600_stateSizeInBytes);
+    finalNode.squeezing = 1;
+    return KeccakWidth1600_12rounds_SpongeSqueeze(&finalNode, output, outLen);
+}
+
+/*
+Each instance hashes one single-node message M || suffix at a time, with its own padding.
+As soon as the last block of a message is permuted, its output is extracted, the instance
+is cleared by adding its own state to itself, and it takes the next message, so messages
+of different lengths keep all the instances busy until the queue runs dry.
+*/
+#define defineParallelBatch( Parallellism ) \
+    static int KangarooTwelve_Batch##Parallellism(const unsigned char * const *inputs, const size_t *inLens, unsigned char * const *outputs, size_t outLen, size_t count, const unsigned char *suffix, size_t suffixLen) \
+    { \
+        ALIGN(KeccakP1600times##Parallellism##_statesAlignment) unsigned char states[KeccakP1600times##Parallellism##_statesSizeInBytes]; \
+        unsigned char block[rateInBytes]; \
+        unsigned char stateBytes[KeccakP1600_stateSizeInBytes]; \
+        size_t message[Parallellism]; \
+        size_t offset[Parallellism]; \
+        size_t next = 0; \
+        unsigned int i, activeCount = 0; \
+        \
+        KeccakP1600times##Parallellism##_StaticInitialize(); \
+        KeccakP1600times##Parallellism##_InitializeAll(states); \
+        for ( i = 0; i < Parallellism; ++i ) { \
+            while ( (next < count) && !isSingleNode(next) ) \
+                ++next; \
+            message[i] = next; \
+            offset[i] = 0; \
+            if ( next < count ) { \
+                ++activeCount; \
+                ++next; \
+            } \
+        } \
+        while ( activeCount > 0 ) { \
+            for ( i = 0; i < Parallellism; ++i ) { \
+                size_t m = message[i]; \
+                if ( m < count ) { \
+                    size_t len = inLens[m] + suffixLen - offset[i]; \
+                    if ( len >= rateInBytes ) { \
+                        KeccakP1600times##Parallellism##_AddBytes(states, i, KangarooTwelve_BatchBlock(inputs[m], inLens[m], suffix, offset[i], rateInBytes, block), 0, rateInBytes); \
+                        offset[i] += rateInBytes; \
+                    } \
+                    else { \
+                        if ( len > 0 ) \
+                            KeccakP1600times##Parallellism##_AddBytes(states, i, KangarooTwelve_BatchBlock(inputs[m], inLens[m], suffix, offset[i], (unsigned int)len, block), 0, (unsigned int)len); \
+                        KeccakP1600times##Parallellism##_AddByte(states, i, 0x07, (unsigned int)len); /* '11': message hop, final node */ \
+                        KeccakP1600times##Parallellism##_AddByte(states, i, 0x80, rateInBytes-1); \
+                        offset[i] = inLens[m] + suffixLen + 1; \
+                    } \
+                } \
+            } \
+            KeccakP1600times##Parallellism##_PermuteAll_12rounds(states); \
+            for ( i = 0; i < Parallellism; ++i ) { \
+                size_t m = message[i]; \
+                if ( (m < count) && (offset[i] > inLens[m] + suffixLen) ) { \
+                    if ( outLen <= rateInBytes ) \
+                        KeccakP1600times##Parallellism##_ExtractBytes(states, i, outputs[m], 0, (unsigned int)outLen); \
+                    else { \
+                        KeccakP1600times##Parallellism##_ExtractBytes(states, i, stateBytes, 0, KeccakP1600_stateSizeInBytes); \
+                        if (KangarooTwelve_BatchSqueeze(stateBytes, outputs[m], outLen) != 0) \
+                            return 1; \
+                    } \
+                    while ( (next < count) && !isSingleNode(next) ) \
+                        ++next; \
+                    message[i] = next; \
+                    offset[i] = 0; \
+                    if ( next < count ) { \
+                        if ( outLen <= rateInBytes ) \
+                            KeccakP1600times##Parallellism##_ExtractBytes(states, i, stateBytes, 0, KeccakP1600_stateSizeInBytes); \
+                        KeccakP1600times##Parallellism##_AddBytes(states, i, stateBytes, 0, KeccakP1600_stateSizeInBytes); \
+                        ++next; \
+                    } \
+                    else \
+                        --activeCount; \
+                } \
+            } \
+        } \
+        return 0; \
+    }
+
+#endif
+
+#if defined(KeccakP1600times8_implementation) && !defined(KeccakP1600times8_isFallback)
+defineParallelBatch( 8 )
+#endif
+#if defined(KeccakP1600times4_implementation) && !defined(KeccakP1600times4_isFallback)
+defineParallelBatch( 4 )
+#endif
+#if defined(KeccakP1600times2_implementation) && !defined(KeccakP1600times2_isFallback)
+defineParallelBatch( 2 )
+#endif
+
+int KangarooTwelve_Batch(const unsigned char * const *inputs, const size_t *inLens, unsigned char * const *outputs, size_t outLen, size_t count, const unsigned char *customization, size_t customLen)
+{
+    unsigned char suffix[chunkSize+sizeof(size_t)+1];
+    size_t suffixLen;
+    size_t i;
+
+    if (outLen == 0)
+        return 1;
+
+    /* Messages with customization | right_encode(customLen) appended that do not fit in the final node are hashed one by one */
+    if ( customLen < chunkSize ) {
+        if ( customLen != 0 )
+            memcpy(suffix, customization, customLen);
+        suffixLen = customLen + right_encode(suffix + customLen, customLen);
+    }
+    else
+        suffixLen = chunkSize + 1;
+    if ( suffixLen > chunkSize ) {
+        for ( i = 0; i < count; ++i )
+            if (KangarooTwelve(inputs[i], inLens[i], outputs[i], outLen, customization, customLen) != 0)
+                return 1;
+        return 0;
+    }
+    for ( i = 0; i < count; ++i )
+        if ( !isSingleNode(i) && (KangarooTwelve(inputs[i], inLens[i], outputs[i], outLen, customization, customLen) != 0) )
+            return 1;
+
+    /* Single-node messages, spread over the widest parallel implementation */
+    #if defined(KeccakP1600times8_implementation) && !defined(KeccakP1600times8_isFallback)
+    #if defined(KeccakP1600times8_isDispatched)
+    if (KeccakP1600times8_IsAvailable())
+    #endif
+        return KangarooTwelve_Batch8(inputs, inLens, outputs, outLen, count, suffix, suffixLen);
+    #endif
+    #if defined(KeccakP1600times4_implementation) && !defined(KeccakP1600times4_isFallback)
+    #if defined(KeccakP1600times4_isDispatched)
+    if (KeccakP1600times4_IsAvailable())
+    #endif
+        return KangarooTwelve_Batch4(inputs, inLens, outputs, outLen, count, suffix, suffixLen);
+    #endif
+    #if defined(KeccakP1600times2_implementation) && !defined(KeccakP1600times2_isFallback)
+    #if defined(KeccakP1600times2_isDispatched)
+    if (KeccakP1600times2_IsAvailable())
+    #endif
+        return KangarooTwelve_Batch2(inputs, inLens, outputs, outLen, count, suffix, suffixLen);
+    #endif
+    for ( i = 0; i < count; ++i )
+        if ( isSingleNode(i) && (KangarooTwelve(inputs[i], inLens[i], outputs[i], outLen, customization, customLen) != 0) )
+            return 1;
+    return 0;
+}
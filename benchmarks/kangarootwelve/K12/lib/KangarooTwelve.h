@@ -51,8 +51,34 @@ typedef struct {
     size_t blockNumber;
     unsigned int queueAbsorbedLen;
     KangarooTwelve_Phases phase;
+    unsigned char *stagingBuffer;
+    size_t stagingLen;
+    unsigned char pendingCVs[168];
+    unsigned int pendingCVsLen;
+    unsigned char *chainingValueSink;
+    size_t chainingValueSinkLen;
 } KangarooTwelve_Instance;
 
+typedef struct {
+    const unsigned char *outboard;
+    const unsigned char *hash;
+    size_t hashByteLen;
+    const unsigned char *customization;
+    size_t customByteLen;
+    size_t inputByteLen;
+    size_t leafCount;
+    size_t position;
+    int failed;
+    unsigned int queueLen;
+    unsigned char queue[8192];
+} KangarooTwelve_Verifier;
+
+/** Size of the staging buffer of KangarooTwelve_InitializeBuffered(): 8 leaves of 8192 bytes. */
+#define KangarooTwelve_stagingBufferSize    (8*8192)
+
+/** Size of the state written by KangarooTwelve_Export(). */
+#define KangarooTwelve_exportSize           (4+1+8+8+2+1+2*202+168)
+
 /** Extendable ouput function KangarooTwelve.
   * @param  input           Pointer to the input message (M).
   * @param  inputByteLen    The length of the input message in bytes.
@@ -64,6 +90,22 @@ typedef struct {
   */
 int KangarooTwelve(const unsigned char *input, size_t inputByteLen, unsigned char *output, size_t outputByteLen, const unsigned char *customization, size_t customByteLen );
 
+/** Extendable ouput function KangarooTwelve applied to many independent messages at once.
+  * The messages that fit in a single node (i.e., whose length plus that of the encoded
+  * customization string is at most 8192 bytes) are spread over the parallel implementations,
+  * so that short messages benefit from SIMD instructions too.
+  * The outputs are identical to those of KangarooTwelve() applied to each message.
+  * @param  inputs          Array of @a count pointers to the input messages (M).
+  * @param  inputByteLens   Array of @a count lengths of the input messages in bytes.
+  * @param  outputs         Array of @a count pointers to the output buffers.
+  * @param  outputByteLen   The desired number of output bytes for each message.
+  * @param  count           The number of messages.
+  * @param  customization   Pointer to the customization string (C), common to all messages.
+  * @param  customByteLen   The length of the customization string in bytes.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_Batch(const unsigned char * const *inputs, const size_t *inputByteLens, unsigned char * const *outputs, size_t outputByteLen, size_t count, const unsigned char *customization, size_t customByteLen);
+
 /**
   * Function to initialize a KangarooTwelve instance.
   * @param  ktInstance      Pointer to the instance to be initialized.
@@ -73,6 +115,48 @@ int KangarooTwelve(const unsigned char *input, size_t inputByteLen, unsigned cha
   */
 int KangarooTwelve_Initialize(KangarooTwelve_Instance *ktInstance, size_t outputByteLen);
 
+/**
+  * Function to initialize a KangarooTwelve instance in buffered mode.
+  * Instead of hashing the leaves one by one when they are given in small pieces,
+  * the instance gathers them in the staging buffer and hashes them 8 at a time,
+  * so that the parallel implementations are used whatever the size of the updates.
+  * This is the way to hash input scattered over many short segments, e.g., network packets,
+  * with one call to KangarooTwelve_Update() per segment.
+  * The output is the same as with KangarooTwelve_Initialize().
+  * @param  ktInstance      Pointer to the instance to be initialized.
+  * @param  outputByteLen   The desired number of output bytes,
+  *                         or 0 for an arbitrarily-long output.
+  * @param  stagingBuffer   Pointer to a buffer of KangarooTwelve_stagingBufferSize bytes,
+  *                         preferably aligned on 64 bytes, used by the instance until
+  *                         KangarooTwelve_Final() returns.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_InitializeBuffered(KangarooTwelve_Instance *ktInstance, size_t outputByteLen, unsigned char *stagingBuffer);
+
+/**
+  * Function to switch an instance to or from buffered mode while absorbing,
+  * e.g., for a series of small updates. The output is not affected.
+  * @param  ktInstance      Pointer to the instance initialized by KangarooTwelve_Initialize().
+  * @param  stagingBuffer   Pointer to a buffer of KangarooTwelve_stagingBufferSize bytes
+  *                         as for KangarooTwelve_InitializeBuffered(), or NULL to leave buffered mode,
+  *                         after which the previous staging buffer is not used any more.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_SetStagingBuffer(KangarooTwelve_Instance *ktInstance, unsigned char *stagingBuffer);
+
+/**
+  * Function to have the instance write out the chaining values of the leaves it hashes,
+  * e.g., to update the output with KangarooTwelve_Rehash() when a few chunks of the input change.
+  * The chaining value of the chunk at offset 8192*i of M || C || right_encode(|C|), for i >= 1,
+  * is written at @a chainingValues + 32*(i-1).
+  * @param  ktInstance      Pointer to the instance just initialized, before any input.
+  * @param  chainingValues  Pointer to the buffer where to write the chaining values.
+  * @param  maxLeafCount    The number of chaining values the buffer can hold,
+  *                         see KangarooTwelve_LeafCount(). Hashing more leaves fails.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_SetChainingValueSink(KangarooTwelve_Instance *ktInstance, unsigned char *chainingValues, size_t maxLeafCount);
+
 /**
   * Function to give input data to be absorbed.
   * @param  ktInstance      Pointer to the instance initialized by KangarooTwelve_Initialize().
@@ -82,6 +166,29 @@ int KangarooTwelve_Initialize(KangarooTwelve_Instance *ktInstance, size_t output
   */
 int KangarooTwelve_Update(KangarooTwelve_Instance *ktInstance, const unsigned char *input, size_t inputByteLen);
 
+/**
+  * Thread pool through which KangarooTwelve_UpdateParallel() spreads the leaves over several threads.
+  * The library itself does not create threads: the caller provides a @a run function that
+  * calls @a job(@a jobContext, i) for every i in [0, @a jobCount), possibly concurrently
+  * and in any order, and returns only when all the calls have returned.
+  */
+typedef struct {
+    void *context;  /* passed as @a poolContext to @a run */
+    void (*run)(void *poolContext, void (*job)(void *jobContext, size_t jobIndex), void *jobContext, size_t jobCount);
+} KangarooTwelve_ThreadPool;
+
+/**
+  * Function to give input data to be absorbed, processing the leaves on several threads.
+  * The result is the same as with KangarooTwelve_Update(), with which calls can be interleaved.
+  * Only inputs of more than 64 complete leaves (i.e., 512 KiB) are spread over the threads.
+  * @param  ktInstance      Pointer to the instance initialized by KangarooTwelve_Initialize().
+  * @param  input           Pointer to the input message data (M).
+  * @param  inputByteLen    The number of bytes provided in the input message data.
+  * @param  threadPool      Pointer to the thread pool to use, or NULL to process the leaves in the calling thread.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_UpdateParallel(KangarooTwelve_Instance *ktInstance, const unsigned char *input, size_t inputByteLen, const KangarooTwelve_ThreadPool *threadPool);
+
 /**
   * Function to call after all the input message has been input, and to get
   * output bytes if the length was specified when calling KangarooTwelve_Initialize().
@@ -107,4 +214,106 @@ int KangarooTwelve_Final(KangarooTwelve_Instance *ktInstance, unsigned char *out
   */
 int KangarooTwelve_Squeeze(KangarooTwelve_Instance *ktInstance, unsigned char *output, size_t outputByteLen);
 
+/**
+  * Function to save the state of an instance, e.g., to resume hashing a long stream after an interruption.
+  * The exported state is versioned and does not depend on the platform nor on the implementation
+  * of the permutation, so it can be imported by any build of this library.
+  * In buffered mode, the leaves waiting in the staging buffer are hashed first.
+  * @param  ktInstance      Pointer to the instance initialized by KangarooTwelve_Initialize().
+  * @param  buffer          Pointer to the buffer of KangarooTwelve_exportSize bytes where to write the state.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_Export(KangarooTwelve_Instance *ktInstance, unsigned char *buffer);
+
+/**
+  * Function to restore an instance from a state written by KangarooTwelve_Export().
+  * The restored instance continues where the exported one was, but neither in buffered mode
+  * nor with a chaining value sink.
+  * @param  buffer          Pointer to the KangarooTwelve_exportSize bytes of the exported state.
+  * @param  ktInstance      Pointer to the instance to restore.
+  * @return 0 if successful, 1 if the state is not valid or has an unsupported version.
+  */
+int KangarooTwelve_Import(const unsigned char *buffer, KangarooTwelve_Instance *ktInstance);
+
+/**
+  * Function giving the number of leaves, and thus of chaining values, of a message.
+  * @param  inputByteLen    The length of the input message in bytes.
+  * @param  customByteLen   The length of the customization string in bytes.
+  * @return The number of leaves, 0 if the message fits in the final node.
+  */
+size_t KangarooTwelve_LeafCount(size_t inputByteLen, size_t customByteLen);
+
+/**
+  * Function to compute KangarooTwelve again after a few chunks of 8192 bytes of the input changed,
+  * from the chaining values written by an instance with KangarooTwelve_SetChainingValueSink().
+  * Only the changed leaves are hashed again, and the final node absorbs the first chunk
+  * and all the chaining values. The chaining values are updated in place.
+  * The length of the input message and the customization string must be those
+  * with which the chaining values were computed.
+  * @param  input           Pointer to the changed input message (M).
+  * @param  inputByteLen    The length of the input message in bytes.
+  * @param  chainingValues  Pointer to the KangarooTwelve_LeafCount() chaining values.
+  * @param  changedChunks   Array of the indexes of the changed chunks, i.e., their offsets divided by 8192.
+  * @param  changedCount    The number of changed chunks.
+  * @param  output          Pointer to the output buffer.
+  * @param  outputByteLen   The desired number of output bytes.
+  * @param  customization   Pointer to the customization string (C).
+  * @param  customByteLen   The length of the customization string in bytes.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_Rehash(const unsigned char *input, size_t inputByteLen, unsigned char *chainingValues, const size_t *changedChunks, size_t changedCount,
+                          unsigned char *output, size_t outputByteLen, const unsigned char *customization, size_t customByteLen);
+
+/**
+  * Function computing KangarooTwelve together with its outboard, i.e., the KangarooTwelve_LeafCount()
+  * chaining values of 32 bytes with which a KangarooTwelve_Verifier checks the input chunk by chunk.
+  * To compute the outboard while streaming, see KangarooTwelve_SetChainingValueSink().
+  * @param  input           Pointer to the input message (M).
+  * @param  inputByteLen    The length of the input message in bytes.
+  * @param  outboard        Pointer to the buffer where to write the outboard.
+  * @param  output          Pointer to the output buffer.
+  * @param  outputByteLen   The desired number of output bytes.
+  * @param  customization   Pointer to the customization string (C).
+  * @param  customByteLen   The length of the customization string in bytes.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_EncodeOutboard(const unsigned char *input, size_t inputByteLen, unsigned char *outboard,
+                                  unsigned char *output, size_t outputByteLen, const unsigned char *customization, size_t customByteLen);
+
+/**
+  * Function to initialize the verification of an input message received in pieces, e.g., from an untrusted source.
+  * The first chunk of 8192 bytes authenticates the outboard against the expected output,
+  * and each next chunk is then checked against its chaining value in the outboard.
+  * The outboard, the expected output and the customization string must stay available
+  * until the verification ends.
+  * @param  verifier        Pointer to the verifier to be initialized.
+  * @param  inputByteLen    The length of the input message in bytes.
+  * @param  outboard        Pointer to the outboard given by KangarooTwelve_EncodeOutboard().
+  * @param  hash            Pointer to the expected output of KangarooTwelve.
+  * @param  hashByteLen     The length of the expected output in bytes.
+  * @param  customization   Pointer to the customization string (C).
+  * @param  customByteLen   The length of the customization string in bytes.
+  * @return 0 if successful, 1 otherwise.
+  */
+int KangarooTwelve_VerifierInitialize(KangarooTwelve_Verifier *verifier, size_t inputByteLen, const unsigned char *outboard,
+                                      const unsigned char *hash, size_t hashByteLen, const unsigned char *customization, size_t customByteLen);
+
+/**
+  * Function to give the next piece of the input message to be verified.
+  * The complete chunks are checked before the function returns, 8 at a time with the parallel
+  * implementations; the bytes of an incomplete chunk are kept until it is complete.
+  * @param  verifier        Pointer to the verifier initialized by KangarooTwelve_VerifierInitialize().
+  * @param  input           Pointer to the next bytes of the input message.
+  * @param  inputByteLen    The number of bytes provided.
+  * @return 0 if all the complete chunks received so far are authentic, 1 otherwise.
+  */
+int KangarooTwelve_VerifierUpdate(KangarooTwelve_Verifier *verifier, const unsigned char *input, size_t inputByteLen);
+
+/**
+  * Function to call after all the input message has been given to KangarooTwelve_VerifierUpdate().
+  * @param  verifier        Pointer to the verifier initialized by KangarooTwelve_VerifierInitialize().
+  * @return 0 if the whole input message is authentic, 1 otherwise.
+  */
+int KangarooTwelve_VerifierFinal(KangarooTwelve_Verifier *verifier);
+
 #endif
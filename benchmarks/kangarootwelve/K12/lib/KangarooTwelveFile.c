@@ -0,0 +1,259 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+*/
+
+#if !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "KangarooTwelveFile.h"
+
+#define mappingThreshold    (64*1024)                               /* Smaller files are read rather than mapped */
+#define windowSize          (16*KangarooTwelve_stagingBufferSize)   /* 16 groups of 8 leaves, large enough to amortize the system calls */
+#define readBufferSize      windowSize
+#define pipelineBufferSize  (4*KangarooTwelve_stagingBufferSize)    /* Small enough for the buffers in flight to stay in the cache */
+#define pipelineDepth       4
+
+/* Hashes a mapped file one window at a time, asking the kernel for the next window in the meantime */
+static int KangarooTwelve_UpdateMapped(KangarooTwelve_Instance *ktInstance, const unsigned char *data, size_t len)
+{
+    size_t offset;
+
+    posix_madvise((void *)data, len, POSIX_MADV_SEQUENTIAL);
+    for ( offset = 0; offset < len; offset += windowSize ) {
+        size_t windowLen = (len - offset < windowSize) ? (len - offset) : windowSize;
+        if ( len - offset > windowSize ) {
+            /* Starts reading the next window without waiting for it */
+            size_t nextLen = (len - offset - windowSize < windowSize) ? (len - offset - windowSize) : windowSize;
+            posix_madvise((void *)(data + offset + windowSize), nextLen, POSIX_MADV_WILLNEED);
+        }
+        if (KangarooTwelve_Update(ktInstance, data + offset, windowLen) != 0)
+            return 1;
+    }
+    return 0;
+}
+
+/* Reads until the buffer is full or the end of the file is reached, returning the number of bytes read or -1 */
+static ssize_t KangarooTwelve_ReadFully(int fd, unsigned char *buffer, size_t size, int *endOfFile)
+{
+    size_t len = 0;
+
+    while ( len < size ) {
+        ssize_t readLen = read(fd, buffer + len, size - len);
+        if ( readLen < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            return -1;
+        }
+        if ( readLen == 0 ) {
+            *endOfFile = 1;
+            break;
+        }
+        len += (size_t)readLen;
+    }
+    return (ssize_t)len;
+}
+
+/* Hashes what can be read from a file descriptor, in pieces as large as the buffer */
+static int KangarooTwelve_UpdateRead(KangarooTwelve_Instance *ktInstance, int fd)
+{
+    unsigned char *buffer = (unsigned char *)malloc(readBufferSize);
+    int endOfFile = 0;
+
+    if (buffer == NULL)
+        return 1;
+    while ( !endOfFile ) {
+        /* Pipes give little data at a time, gather it so that the parallel implementations can be used */
+        ssize_t len = KangarooTwelve_ReadFully(fd, buffer, readBufferSize, &endOfFile);
+        if ( (len < 0) || (KangarooTwelve_Update(ktInstance, buffer, (size_t)len) != 0) ) {
+            free(buffer);
+            return 1;
+        }
+    }
+    free(buffer);
+    return 0;
+}
+
+int KangarooTwelve_HashFile(const char *path, unsigned char *output, size_t outputByteLen, const unsigned char *customization, size_t customByteLen)
+{
+    KangarooTwelve_Instance ktInstance;
+    struct stat status;
+    int fd, result;
+
+    if (outputByteLen == 0)
+        return 1;
+    if (KangarooTwelve_Initialize(&ktInstance, outputByteLen) != 0)
+        return 1;
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 1;
+    if ( (fstat(fd, &status) == 0) && S_ISREG(status.st_mode) && (status.st_size >= mappingThreshold)
+      && ((unsigned long long)status.st_size <= (size_t)-1) ) {
+        size_t len = (size_t)status.st_size;
+        void *data = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if ( data != MAP_FAILED ) {
+            result = KangarooTwelve_UpdateMapped(&ktInstance, (const unsigned char *)data, len);
+            munmap(data, len);
+        }
+        else
+            result = KangarooTwelve_UpdateRead(&ktInstance, fd);
+    }
+    else
+        result = KangarooTwelve_UpdateRead(&ktInstance, fd);
+    close(fd);
+    if (result != 0)
+        return 1;
+    return KangarooTwelve_Final(&ktInstance, output, customization, customByteLen);
+}
+
+/* ---------------------------------------------------------------- */
+
+/*
+The reader thread fills the buffers in turn while the calling thread hashes the previous ones.
+Buffer i goes to buffers[i % pipelineDepth]; it can be read once buffer i - pipelineDepth is hashed.
+*/
+typedef struct {
+    int fd;
+    unsigned char *buffers[pipelineDepth];
+    size_t lengths[pipelineDepth];
+    size_t filledCount;
+    size_t hashedCount;
+    int endOfFile;
+    int error;
+    pthread_mutex_t mutex;
+    pthread_cond_t filled;
+    pthread_cond_t hashed;
+} KangarooTwelve_Pipeline;
+
+static void *KangarooTwelve_PipelineReader(void *context)
+{
+    KangarooTwelve_Pipeline *pipeline = (KangarooTwelve_Pipeline *)context;
+    size_t index;
+    int stop = 0, cancelState;
+
+    /* Only the reads can be cancelled, so that the reader never stops while holding the mutex */
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+    for ( index = 0; !stop; ++index ) {
+        int endOfFile = 0;
+        ssize_t len;
+
+        pthread_mutex_lock(&pipeline->mutex);
+        while ( (index - pipeline->hashedCount == pipelineDepth) && !pipeline->error )
+            pthread_cond_wait(&pipeline->hashed, &pipeline->mutex);
+        stop = pipeline->error;
+        pthread_mutex_unlock(&pipeline->mutex);
+        if ( stop )
+            break;
+
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &cancelState);
+        len = KangarooTwelve_ReadFully(pipeline->fd, pipeline->buffers[index % pipelineDepth], pipelineBufferSize, &endOfFile);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+
+        pthread_mutex_lock(&pipeline->mutex);
+        if ( len < 0 )
+            pipeline->error = 1;
+        else {
+            pipeline->lengths[index % pipelineDepth] = (size_t)len;
+            pipeline->endOfFile = endOfFile;
+            pipeline->filledCount = index + 1;
+        }
+        stop = pipeline->error || endOfFile;
+        pthread_cond_signal(&pipeline->filled);
+        pthread_mutex_unlock(&pipeline->mutex);
+    }
+    return NULL;
+}
+
+static int KangarooTwelve_UpdatePipelined(KangarooTwelve_Instance *ktInstance, int fd)
+{
+    KangarooTwelve_Pipeline pipeline;
+    pthread_t reader;
+    size_t index;
+    unsigned int i;
+    int error = 0, last = 0, threadStarted;
+
+    pipeline.fd = fd;
+    pipeline.filledCount = 0;
+    pipeline.hashedCount = 0;
+    pipeline.endOfFile = 0;
+    pipeline.error = 0;
+    for ( i = 0; i < pipelineDepth; ++i ) {
+        /* Page-aligned, so that the kernel can copy whole pages */
+        if (posix_memalign((void **)&pipeline.buffers[i], 4096, pipelineBufferSize) != 0) {
+            while ( i > 0 )
+                free(pipeline.buffers[--i]);
+            return 1;
+        }
+    }
+    pthread_mutex_init(&pipeline.mutex, NULL);
+    pthread_cond_init(&pipeline.filled, NULL);
+    pthread_cond_init(&pipeline.hashed, NULL);
+
+    threadStarted = (pthread_create(&reader, NULL, KangarooTwelve_PipelineReader, &pipeline) == 0);
+    if ( !threadStarted ) {
+        /* No thread available, read and hash in turn */
+        error = KangarooTwelve_UpdateRead(ktInstance, fd);
+        last = 1;
+    }
+    for ( index = 0; !error && !last; ++index ) {
+        size_t len;
+
+        pthread_mutex_lock(&pipeline.mutex);
+        while ( (pipeline.filledCount == index) && !pipeline.error )
+            pthread_cond_wait(&pipeline.filled, &pipeline.mutex);
+        error = pipeline.error;
+        len = pipeline.lengths[index % pipelineDepth];
+        last = pipeline.endOfFile && (pipeline.filledCount == index + 1);
+        pthread_mutex_unlock(&pipeline.mutex);
+        if ( error )
+            break;
+
+        /* The buffers hold whole chunks, so after the first one they give whole groups of 8 leaves */
+        error = KangarooTwelve_Update(ktInstance, pipeline.buffers[index % pipelineDepth], len);
+
+        pthread_mutex_lock(&pipeline.mutex);
+        pipeline.hashedCount = index + 1;
+        pipeline.error |= error;
+        pthread_cond_signal(&pipeline.hashed);
+        pthread_mutex_unlock(&pipeline.mutex);
+    }
+    if ( threadStarted ) {
+        /* After a hashing error, the reader may be blocked in read() on a pipe or socket that stays open */
+        if ( error )
+            pthread_cancel(reader);
+        pthread_join(reader, NULL);
+    }
+
+    pthread_cond_destroy(&pipeline.hashed);
+    pthread_cond_destroy(&pipeline.filled);
+    pthread_mutex_destroy(&pipeline.mutex);
+    for ( i = 0; i < pipelineDepth; ++i )
+        free(pipeline.buffers[i]);
+    return error;
+}
+
+int KangarooTwelve_HashFd(int fd, unsigned char *output, size_t outputByteLen, const unsigned char *customization, size_t customByteLen)
+{
+    KangarooTwelve_Instance ktInstance;
+
+    if (outputByteLen == 0)
+        return 1;
+    if (KangarooTwelve_Initialize(&ktInstance, outputByteLen) != 0)
+        return 1;
+    if (KangarooTwelve_UpdatePipelined(&ktInstance, fd) != 0)
+        return 1;
+    return KangarooTwelve_Final(&ktInstance, output, customization, customByteLen);
+}
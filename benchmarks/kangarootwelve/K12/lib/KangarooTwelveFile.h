@@ -0,0 +1,43 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+*/
+
+#ifndef _KangarooTwelveFile_h_
+#define _KangarooTwelveFile_h_
+
+#include <stddef.h>
+#include "KangarooTwelve.h"
+
+/** KangarooTwelve applied to the contents of a file, on POSIX systems.
+  * Regular files are mapped in memory and hashed straight from the page cache,
+  * while small files and other kinds of files (e.g., pipes) are read into a buffer.
+  * The file must not be truncated while it is being hashed.
+  * @param  path            Path of the file holding the input message (M).
+  * @param  output          Pointer to the output buffer.
+  * @param  outputByteLen   The desired number of output bytes.
+  * @param  customization   Pointer to the customization string (C).
+  * @param  customByteLen   The length of the customization string in bytes.
+  * @return 0 if successful, 1 otherwise (including if the file cannot be read).
+  */
+int KangarooTwelve_HashFile(const char *path, unsigned char *output, size_t outputByteLen, const unsigned char *customization, size_t customByteLen);
+
+/** KangarooTwelve applied to what can be read from a file descriptor until its end, on POSIX systems.
+  * A second thread reads the next buffers of 256 KiB while the calling thread hashes the previous ones,
+  * so that reading from a disk or a socket and hashing overlap.
+  * @param  fd              File descriptor, e.g., of a file, a pipe or a socket, open for reading.
+  * @param  output          Pointer to the output buffer.
+  * @param  outputByteLen   The desired number of output bytes.
+  * @param  customization   Pointer to the customization string (C).
+  * @param  customByteLen   The length of the customization string in bytes.
+  * @return 0 if successful, 1 otherwise (including if reading fails).
+  */
+int KangarooTwelve_HashFd(int fd, unsigned char *output, size_t outputByteLen, const unsigned char *customization, size_t customByteLen);
+
+#endif
@@ -42,4 +42,27 @@ void KeccakP1600_Permute_12rounds(void *state);
 void KeccakP1600_ExtractBytes(const void *state, unsigned char *data, unsigned int offset, unsigned int length);
 size_t KeccakP1600_12rounds_FastLoop_Absorb(void *state, unsigned int laneCount, const unsigned char *data, size_t dataByteLen);
 
+#if defined(KeccakP1600_interleavedTimes2)
+/* Two states side by side, their rounds interleaved to keep more execution units busy */
+#define KeccakP1600times2_implementation        "64-bit scalar implementation, 2 instances interleaved"
+#define KeccakP1600times2_statesSizeInBytes     400
+#define KeccakP1600times2_statesAlignment       8
+#define KeccakP1600times2_12rounds_FastLoop_supported
+
+#define KeccakP1600times2_StaticInitialize()
+void KeccakP1600times2_InitializeAll(void *states);
+#if (PLATFORM_BYTE_ORDER == IS_LITTLE_ENDIAN)
+#define KeccakP1600times2_AddByte(states, instanceIndex, byte, offset) \
+    ((unsigned char*)(states))[(instanceIndex)*200 + (offset)] ^= (byte)
+#else
+void KeccakP1600times2_AddByte(void *states, unsigned int instanceIndex, unsigned char byte, unsigned int offset);
+#endif
+void KeccakP1600times2_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times2_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+void KeccakP1600times2_PermuteAll_12rounds(void *states);
+void KeccakP1600times2_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+size_t KeccakP1600times2_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+#endif
+
 #endif
@@ -1,3 +1,6 @@
+/* Unless the file including this one already chose a variant, e.g., the runtime dispatch */
+#if !defined(KeccakP1600_implementation_config)
+
 #define KeccakP1600_implementation_config "all rounds unrolled"
 #define KeccakP1600_fullUnrolling
 
@@ -28,3 +31,11 @@
 #define KeccakP1600_useLaneComplementing
 #define KeccakP1600_useSHLD
 */
+
+#endif
+
+/* In addition, two instances with their rounds interleaved, for the parallel leaves of KangarooTwelve. */
+/* Out-of-order cores already overlap consecutive permutations, so this only pays off on narrower ones. */
+/*
+#define KeccakP1600_interleavedTimes2
+*/
@@ -0,0 +1,170 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+/*
+Two instances of Keccak-p[1600] with 64-bit scalar instructions only.
+The states are simply consecutive, each in the layout of the single-instance implementation,
+but their rounds are interleaved so that an out-of-order core can overlap two independent
+dependency chains instead of one.
+*/
+
+#include <string.h>
+#include "brg_endian.h"
+#include "KeccakP-1600-config.h"
+#include "KeccakP-1600-SnP.h"
+
+#if defined(KeccakP1600_interleavedTimes2)
+
+typedef unsigned char UINT8;
+typedef unsigned long long int UINT64;
+
+/* Its own copy of the round constants, as KeccakP-1600-opt64.c may precede in the same translation unit */
+#define KeccakF1600RoundConstants KeccakP1600times2_RoundConstants
+#include "KeccakP-1600-64.macros"
+
+#define stateSize   200
+
+#define declareAE(X) \
+    UINT64 X##Aba, X##Abe, X##Abi, X##Abo, X##Abu; \
+    UINT64 X##Aga, X##Age, X##Agi, X##Ago, X##Agu; \
+    UINT64 X##Aka, X##Ake, X##Aki, X##Ako, X##Aku; \
+    UINT64 X##Ama, X##Ame, X##Ami, X##Amo, X##Amu; \
+    UINT64 X##Asa, X##Ase, X##Asi, X##Aso, X##Asu; \
+    UINT64 X##Eba, X##Ebe, X##Ebi, X##Ebo, X##Ebu; \
+    UINT64 X##Ega, X##Ege, X##Egi, X##Ego, X##Egu; \
+    UINT64 X##Eka, X##Eke, X##Eki, X##Eko, X##Eku; \
+    UINT64 X##Ema, X##Eme, X##Emi, X##Emo, X##Emu; \
+    UINT64 X##Esa, X##Ese, X##Esi, X##Eso, X##Esu; \
+
+#define declareBCD \
+    UINT64 Bba, Bbe, Bbi, Bbo, Bbu; \
+    UINT64 Bga, Bge, Bgi, Bgo, Bgu; \
+    UINT64 Bka, Bke, Bki, Bko, Bku; \
+    UINT64 Bma, Bme, Bmi, Bmo, Bmu; \
+    UINT64 Bsa, Bse, Bsi, Bso, Bsu; \
+    UINT64 Ca, Ce, Ci, Co, Cu; \
+    UINT64 Da, De, Di, Do, Du; \
+
+#define prepareThetaOf(A) \
+    Ca = A##ba^A##ga^A##ka^A##ma^A##sa; \
+    Ce = A##be^A##ge^A##ke^A##me^A##se; \
+    Ci = A##bi^A##gi^A##ki^A##mi^A##si; \
+    Co = A##bo^A##go^A##ko^A##mo^A##so; \
+    Cu = A##bu^A##gu^A##ku^A##mu^A##su; \
+
+/* Each instance gets its own temporaries, so the compiler can schedule the two rounds together */
+#define roundTimes2(i, A, E) \
+    { \
+        declareBCD \
+        prepareThetaOf(X##A) \
+        thetaRhoPiChiIota(i, X##A, X##E) \
+    } \
+    { \
+        declareBCD \
+        prepareThetaOf(Y##A) \
+        thetaRhoPiChiIota(i, Y##A, Y##E) \
+    } \
+
+#define rounds12Times2 \
+    roundTimes2(12, A, E) \
+    roundTimes2(13, E, A) \
+    roundTimes2(14, A, E) \
+    roundTimes2(15, E, A) \
+    roundTimes2(16, A, E) \
+    roundTimes2(17, E, A) \
+    roundTimes2(18, A, E) \
+    roundTimes2(19, E, A) \
+    roundTimes2(20, A, E) \
+    roundTimes2(21, E, A) \
+    roundTimes2(22, A, E) \
+    roundTimes2(23, E, A) \
+
+void KeccakP1600times2_InitializeAll(void *states)
+{
+    KeccakP1600_Initialize(states);
+    KeccakP1600_Initialize((UINT8*)states + stateSize);
+}
+
+void KeccakP1600times2_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length)
+{
+    KeccakP1600_AddBytes((UINT8*)states + instanceIndex*stateSize, data, offset, length);
+}
+
+#if (PLATFORM_BYTE_ORDER != IS_LITTLE_ENDIAN)
+void KeccakP1600times2_AddByte(void *states, unsigned int instanceIndex, unsigned char byte, unsigned int offset)
+{
+    KeccakP1600_AddByte((UINT8*)states + instanceIndex*stateSize, byte, offset);
+}
+#endif
+
+void KeccakP1600times2_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    KeccakP1600_AddBytes(states, data, 0, laneCount*8);
+    KeccakP1600_AddBytes((UINT8*)states + stateSize, data + laneOffset*8, 0, laneCount*8);
+}
+
+void KeccakP1600times2_PermuteAll_12rounds(void *states)
+{
+    declareAE(X)
+    declareAE(Y)
+    UINT64 *stateX = (UINT64*)states;
+    UINT64 *stateY = stateX + 25;
+
+    copyFromState(XA, stateX)
+    copyFromState(YA, stateY)
+    rounds12Times2
+    copyToState(stateX, XA)
+    copyToState(stateY, YA)
+}
+
+void KeccakP1600times2_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length)
+{
+    KeccakP1600_ExtractBytes((const UINT8*)states + instanceIndex*stateSize, data, offset, length);
+}
+
+void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    KeccakP1600_ExtractBytes(states, data, 0, laneCount*8);
+    KeccakP1600_ExtractBytes((const UINT8*)states + stateSize, data + laneOffset*8, 0, laneCount*8);
+}
+
+size_t KeccakP1600times2_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen)
+{
+    size_t originalDataByteLen = dataByteLen;
+    declareAE(X)
+    declareAE(Y)
+    UINT64 *stateX = (UINT64*)states;
+    UINT64 *stateY = stateX + 25;
+    const UINT64 *inDataX = (const UINT64*)data;
+    const UINT64 *inDataY = inDataX + laneOffsetParallel;
+
+    copyFromState(XA, stateX)
+    copyFromState(YA, stateY)
+    while(dataByteLen >= (laneOffsetParallel + laneCount)*8) {
+        addInput(XA, inDataX, laneCount)
+        addInput(YA, inDataY, laneCount)
+        rounds12Times2
+        inDataX += laneOffsetSerial;
+        inDataY += laneOffsetSerial;
+        dataByteLen -= laneOffsetSerial*8;
+    }
+    copyToState(stateX, XA)
+    copyToState(stateY, YA)
+    return originalDataByteLen - dataByteLen;
+}
+
+#undef KeccakF1600RoundConstants
+
+#endif
@@ -6,3 +6,18 @@
 #define KeccakP1600times4_implementation_config "AVX2, 12 rounds unrolled"
 #define KeccakP1600times4_unrolling 12
 #define KeccakP1600times4_useAVX2
+/* Distance in bytes at which the input of each instance is prefetched, not a measurable gain so far. */
+/*
+#define KeccakP1600times4_prefetchDistance 512
+*/
+
+/* In addition, eight instances as two sets of four with their rounds interleaved. */
+/* Two consecutive ×4 passes are faster on the cores measured so far, hence not enabled by default. */
+/*
+#define KeccakP1600times8_interleavedTimes4
+*/
+#define KeccakP1600times8_implementation_config "AVX2, two interleaved sets of 4, 12 rounds unrolled"
+#define KeccakP1600times8_useAVX2
+/*
+#define KeccakP1600times8_prefetchDistance 512
+*/
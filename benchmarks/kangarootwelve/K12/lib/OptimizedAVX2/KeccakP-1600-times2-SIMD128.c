@@ -57,10 +57,10 @@ typedef __m128i V128;
         #define ROL64in128_56(a)    ROL64in128(a, 56)
     #else
         #define ROL64in128(a, o)    _mm_or_si128(_mm_slli_epi64(a, o), _mm_srli_epi64(a, 64-(o)))
-        #define ROL64in128_8(a)     _mm_shuffle_epi8(a, CONST128(rho8))
-        #define ROL64in128_56(a)    _mm_shuffle_epi8(a, CONST128(rho56))
-static const UINT64 rho8[2] = {0x0605040302010007, 0x0E0D0C0B0A09080F};
-static const UINT64 rho56[2] = {0x0007060504030201, 0x080F0E0D0C0B0A09};
+        #define ROL64in128_8(a)     _mm_shuffle_epi8(a, CONST128(KeccakP1600times2_rho8))
+        #define ROL64in128_56(a)    _mm_shuffle_epi8(a, CONST128(KeccakP1600times2_rho56))
+static const UINT64 KeccakP1600times2_rho8[2] = {0x0605040302010007, 0x0E0D0C0B0A09080F};
+static const UINT64 KeccakP1600times2_rho56[2] = {0x0007060504030201, 0x080F0E0D0C0B0A09};
     #endif
     #define STORE128(a, b)      _mm_store_si128((V128 *)&(a), b)
     #define STORE128u(a, b)     _mm_storeu_si128((V128 *)&(a), b)
@@ -315,7 +315,7 @@ void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data,
     XOReq128(A##ki, Di); \
     Bbi = ROL64in128(A##ki, 43); \
     E##ba = XOR128(Bba, ANDnu128(Bbe, Bbi)); \
-    XOReq128(E##ba, CONST128_64(KeccakF1600RoundConstants[i])); \
+    XOReq128(E##ba, CONST128_64(KeccakP1600times2_RoundConstants[i])); \
     Ca = E##ba; \
     XOReq128(A##mo, Do); \
     Bbo = ROL64in128(A##mo, 21); \
@@ -431,7 +431,7 @@ void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data,
     XOReq128(A##ki, Di); \
     Bbi = ROL64in128(A##ki, 43); \
     E##ba = XOR128(Bba, ANDnu128(Bbe, Bbi)); \
-    XOReq128(E##ba, CONST128_64(KeccakF1600RoundConstants[i])); \
+    XOReq128(E##ba, CONST128_64(KeccakP1600times2_RoundConstants[i])); \
     XOReq128(A##mo, Do); \
     Bbo = ROL64in128(A##mo, 21); \
     E##be = XOR128(Bbe, ANDnu128(Bbi, Bbo)); \
@@ -506,7 +506,7 @@ void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data,
     E##su = XOR128(Bsu, ANDnu128(Bsa, Bse)); \
 \
 
-static ALIGN(KeccakP1600times2_statesAlignment) const UINT64 KeccakF1600RoundConstants[24] = {
+static ALIGN(KeccakP1600times2_statesAlignment) const UINT64 KeccakP1600times2_RoundConstants[24] = {
     0x0000000000000001ULL,
     0x0000000000008082ULL,
     0x800000000000808aULL,
@@ -702,3 +702,17 @@ void KeccakP1600times2_PermuteAll_12rounds(void *states)
     _mm_empty();
 #endif
 }
+
+/* The ×4 and ×8 define these differently, and may follow in the same translation unit (libk12-amalgamated.a) */
+#undef laneIndex
+#undef UNPACKL
+#undef UNPACKH
+#undef declareABCDE
+#undef prepareTheta
+#undef thetaRhoPiChiIotaPrepareTheta
+#undef thetaRhoPiChiIota
+#undef copyFromState
+#undef copyToState
+#undef Unrolling
+#undef FullUnrolling
+#undef rounds12
@@ -58,10 +58,10 @@ typedef __m256i V256;
     #define LOAD256u(a)             _mm256_loadu_si256((const V256 *)&(a))
     #define LOAD4_64(a, b, c, d)    _mm256_set_epi64x((UINT64)(a), (UINT64)(b), (UINT64)(c), (UINT64)(d))
     #define ROL64in256(d, a, o)     d = _mm256_or_si256(_mm256_slli_epi64(a, o), _mm256_srli_epi64(a, 64-(o)))
-    #define ROL64in256_8(d, a)      d = _mm256_shuffle_epi8(a, CONST256(rho8))
-    #define ROL64in256_56(d, a)     d = _mm256_shuffle_epi8(a, CONST256(rho56))
-static const UINT64 rho8[4] = {0x0605040302010007, 0x0E0D0C0B0A09080F, 0x1615141312111017, 0x1E1D1C1B1A19181F};
-static const UINT64 rho56[4] = {0x0007060504030201, 0x080F0E0D0C0B0A09, 0x1017161514131211, 0x181F1E1D1C1B1A19};
+    #define ROL64in256_8(d, a)      d = _mm256_shuffle_epi8(a, CONST256(KeccakP1600times4_rho8))
+    #define ROL64in256_56(d, a)     d = _mm256_shuffle_epi8(a, CONST256(KeccakP1600times4_rho56))
+static const UINT64 KeccakP1600times4_rho8[4] = {0x0605040302010007, 0x0E0D0C0B0A09080F, 0x1615141312111017, 0x1E1D1C1B1A19181F};
+static const UINT64 KeccakP1600times4_rho56[4] = {0x0007060504030201, 0x080F0E0D0C0B0A09, 0x1017161514131211, 0x181F1E1D1C1B1A19};
     #define STORE256(a, b)          _mm256_store_si256((V256 *)&(a), b)
     #define STORE256u(a, b)         _mm256_storeu_si256((V256 *)&(a), b)
     #define STORE2_128(ah, al, v)   _mm256_storeu2_m128d((V128*)&(ah), (V128*)&(al), v)
@@ -92,6 +92,19 @@ static const UINT64 rho56[4] = {0x0007060504030201, 0x080F0E0D0C0B0A09, 0x101716
 
 #endif
 
+#if defined(KeccakP1600times4_prefetchDistance)
+/* Requests the 168 bytes that the instance reading at p absorbs KeccakP1600times4_prefetchDistance bytes later */
+#define PREFETCH_BLOCK(p) \
+    { \
+        const char *q = (const char *)(p) + KeccakP1600times4_prefetchDistance; \
+        _mm_prefetch(q, _MM_HINT_T0); \
+        _mm_prefetch(q + 64, _MM_HINT_T0); \
+        _mm_prefetch(q + 128, _MM_HINT_T0); \
+    }
+#else
+#define PREFETCH_BLOCK(p)
+#endif
+
 #define SnP_laneLengthInBytes 8
 
 void KeccakP1600times4_InitializeAll(void *states)
@@ -307,7 +320,7 @@ void KeccakP1600times4_ExtractLanesAll(const void *states, unsigned char *data,
     XOReq256(A##ki, Di); \
     ROL64in256(Bbi, A##ki, 43); \
     E##ba = XOR256(Bba, ANDnu256(Bbe, Bbi)); \
-    XOReq256(E##ba, CONST256_64(KeccakF1600RoundConstants[i])); \
+    XOReq256(E##ba, CONST256_64(KeccakP1600times4_RoundConstants[i])); \
     Ca = E##ba; \
     XOReq256(A##mo, Do); \
     ROL64in256(Bbo, A##mo, 21); \
@@ -428,7 +441,7 @@ void KeccakP1600times4_ExtractLanesAll(const void *states, unsigned char *data,
     XOReq256(A##ki, Di); \
     ROL64in256(Bbi, A##ki, 43); \
     E##ba = XOR256(Bba, ANDnu256(Bbe, Bbi)); \
-    XOReq256(E##ba, CONST256_64(KeccakF1600RoundConstants[i])); \
+    XOReq256(E##ba, CONST256_64(KeccakP1600times4_RoundConstants[i])); \
     XOReq256(A##mo, Do); \
     ROL64in256(Bbo, A##mo, 21); \
     E##be = XOR256(Bbe, ANDnu256(Bbi, Bbo)); \
@@ -503,7 +516,7 @@ void KeccakP1600times4_ExtractLanesAll(const void *states, unsigned char *data,
     E##su = XOR256(Bsu, ANDnu256(Bsa, Bse)); \
 \
 
-static ALIGN(KeccakP1600times4_statesAlignment) const UINT64 KeccakF1600RoundConstants[24] = {
+static ALIGN(KeccakP1600times4_statesAlignment) const UINT64 KeccakP1600times4_RoundConstants[24] = {
     0x0000000000000001ULL,
     0x0000000000008082ULL,
     0x800000000000808aULL,
@@ -711,6 +724,10 @@ size_t KeccakP1600times4_12rounds_FastLoop_Absorb(void *states, unsigned int lan
 
         copyFromState(A, statesAsLanes)
         while(dataByteLen >= (laneOffsetParallel*3 + laneCount)*8) {
+            PREFETCH_BLOCK(curData0)
+            PREFETCH_BLOCK(curData1)
+            PREFETCH_BLOCK(curData2)
+            PREFETCH_BLOCK(curData3)
             #define XOR_In( Xxx, argIndex ) \
                 XOReq256(Xxx, LOAD4_64(curData3[argIndex], curData2[argIndex], curData1[argIndex], curData0[argIndex]))
             XOR_In( Aba, 0 );
@@ -758,3 +775,112 @@ size_t KeccakP1600times4_12rounds_FastLoop_Absorb(void *states, unsigned int lan
         return data - dataStart;
     }
 }
+
+/* KangarooTwelve leaves: 8192 bytes = 48 blocks of 21 lanes + 16 lanes, suffix 0x0B, 32-byte chaining values */
+#define LeafCVs_chunkLanes      (8192/8)
+#define LeafCVs_fullBlocks      (8192/168)
+
+void KeccakP1600times4_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues)
+{
+    const UINT64 *curData0 = (const UINT64 *)data;
+    const UINT64 *curData1 = curData0 + 1*LeafCVs_chunkLanes;
+    const UINT64 *curData2 = curData0 + 2*LeafCVs_chunkLanes;
+    const UINT64 *curData3 = curData0 + 3*LeafCVs_chunkLanes;
+    UINT64 *cvsAsLanes = (UINT64 *)chainingValues;
+    const UINT64 suffix = 0x0B;
+    const UINT64 padding = 0x8000000000000000ULL;
+    V256 lanes0, lanes1, lanes2, lanes3, lanesL01, lanesL23, lanesH01, lanesH23;
+    unsigned int j;
+    declareABCDE
+    #if !defined(FullUnrolling) && (Unrolling < 12)
+    unsigned int i;
+    #endif
+
+    Aba = Abe = Abi = Abo = Abu = _mm256_setzero_si256();
+    Aga = Age = Agi = Ago = Agu = _mm256_setzero_si256();
+    Aka = Ake = Aki = Ako = Aku = _mm256_setzero_si256();
+    Ama = Ame = Ami = Amo = Amu = _mm256_setzero_si256();
+    Asa = Ase = Asi = Aso = Asu = _mm256_setzero_si256();
+
+    #define XOR_In( Xxx, argIndex ) \
+        XOReq256(Xxx, LOAD4_64(curData3[argIndex], curData2[argIndex], curData1[argIndex], curData0[argIndex]))
+    for(j=0; j<LeafCVs_fullBlocks; j++) {
+        PREFETCH_BLOCK(curData0)
+        PREFETCH_BLOCK(curData1)
+        PREFETCH_BLOCK(curData2)
+        PREFETCH_BLOCK(curData3)
+        XOR_In( Aba, 0 );
+        XOR_In( Abe, 1 );
+        XOR_In( Abi, 2 );
+        XOR_In( Abo, 3 );
+        XOR_In( Abu, 4 );
+        XOR_In( Aga, 5 );
+        XOR_In( Age, 6 );
+        XOR_In( Agi, 7 );
+        XOR_In( Ago, 8 );
+        XOR_In( Agu, 9 );
+        XOR_In( Aka, 10 );
+        XOR_In( Ake, 11 );
+        XOR_In( Aki, 12 );
+        XOR_In( Ako, 13 );
+        XOR_In( Aku, 14 );
+        XOR_In( Ama, 15 );
+        XOR_In( Ame, 16 );
+        XOR_In( Ami, 17 );
+        XOR_In( Amo, 18 );
+        XOR_In( Amu, 19 );
+        XOR_In( Asa, 20 );
+        rounds12
+        curData0 += 21;
+        curData1 += 21;
+        curData2 += 21;
+        curData3 += 21;
+    }
+
+    /* Last block: 16 lanes of data, then the suffix and the padding */
+    XOR_In( Aba, 0 );
+    XOR_In( Abe, 1 );
+    XOR_In( Abi, 2 );
+    XOR_In( Abo, 3 );
+    XOR_In( Abu, 4 );
+    XOR_In( Aga, 5 );
+    XOR_In( Age, 6 );
+    XOR_In( Agi, 7 );
+    XOR_In( Ago, 8 );
+    XOR_In( Agu, 9 );
+    XOR_In( Aka, 10 );
+    XOR_In( Ake, 11 );
+    XOR_In( Aki, 12 );
+    XOR_In( Ako, 13 );
+    XOR_In( Aku, 14 );
+    XOR_In( Ama, 15 );
+    #undef XOR_In
+    XOReq256(Ame, CONST256_64(suffix));
+    XOReq256(Asa, CONST256_64(padding));
+    rounds12
+
+    /* The chaining values are the first 4 lanes of each instance */
+    lanes0 = Aba;
+    lanes1 = Abe;
+    lanes2 = Abi;
+    lanes3 = Abo;
+    UNINTLEAVE();
+    STORE256u( cvsAsLanes[0], lanes0 );
+    STORE256u( cvsAsLanes[4], lanes1 );
+    STORE256u( cvsAsLanes[8], lanes2 );
+    STORE256u( cvsAsLanes[12], lanes3 );
+}
+
+/* Out of the way of the next source when the library is built as a single translation unit */
+#undef laneIndex
+#undef UNPACKL
+#undef UNPACKH
+#undef declareABCDE
+#undef prepareTheta
+#undef thetaRhoPiChiIotaPrepareTheta
+#undef thetaRhoPiChiIota
+#undef copyFromState
+#undef copyToState
+#undef Unrolling
+#undef FullUnrolling
+#undef rounds12
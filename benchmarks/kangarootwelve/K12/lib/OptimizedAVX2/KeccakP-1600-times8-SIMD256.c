@@ -0,0 +1,788 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#include <immintrin.h>
+#include <emmintrin.h>
+#include "KeccakP-1600-SnP.h"
+
+#include "brg_endian.h"
+#if (PLATFORM_BYTE_ORDER != IS_LITTLE_ENDIAN)
+#error Expecting a little-endian platform
+#endif
+
+#if defined(KeccakP1600times8_interleavedTimes4)
+
+#ifdef ALIGN
+#undef ALIGN
+#endif
+
+#if defined(__GNUC__)
+#define ALIGN(x) __attribute__ ((aligned(x)))
+#elif defined(_MSC_VER)
+#define ALIGN(x) __declspec(align(x))
+#elif defined(__ARMCC_VERSION)
+#define ALIGN(x) __align(x)
+#else
+#define ALIGN(x)
+#endif
+
+typedef unsigned char UINT8;
+typedef unsigned long long int UINT64;
+typedef __m128i V128;
+typedef __m256i V256;
+
+/*
+Eight instances as two sets of four, instances 0 to 3 and 4 to 7.
+The lanes are interleaved as in the 512-bit implementation, so each lane position holds
+one 256-bit word per set, and the rounds of the two sets are interleaved plane by plane
+so that the core always has a second, independent dependency chain to work on.
+*/
+
+#define laneIndex(instanceIndex, lanePosition) ((lanePosition)*8 + instanceIndex)
+
+#if defined(KeccakP1600times8_useAVX2) || defined(KeccakP1600times8_useAVX512VL)
+    #define ANDnu256(a, b)          _mm256_andnot_si256(a, b)
+    #define CONST256(a)             _mm256_load_si256((const V256 *)&(a))
+    #define CONST256_64(a)          (V256)_mm256_broadcast_sd((const double*)(&a))
+    #define LOAD256(a)              _mm256_load_si256((const V256 *)&(a))
+    #define LOAD256u(a)             _mm256_loadu_si256((const V256 *)&(a))
+    #define LOAD4_64(a, b, c, d)    _mm256_set_epi64x((UINT64)(a), (UINT64)(b), (UINT64)(c), (UINT64)(d))
+#if defined(KeccakP1600times8_useAVX512VL)
+    /* AVX-512VL on ymm registers: native rotations and a single ternary-logic chi */
+    #define CHI256(a, b, c)         _mm256_ternarylogic_epi64(a, b, c, 0xD2)
+    #define ROL64in256(d, a, o)     d = _mm256_rol_epi64(a, o)
+    #define ROL64in256_8(d, a)      d = _mm256_rol_epi64(a, 8)
+    #define ROL64in256_56(d, a)     d = _mm256_rol_epi64(a, 56)
+#else
+    #define CHI256(a, b, c)         XOR256(a, ANDnu256(b, c))
+    #define ROL64in256(d, a, o)     d = _mm256_or_si256(_mm256_slli_epi64(a, o), _mm256_srli_epi64(a, 64-(o)))
+    #define ROL64in256_8(d, a)      d = _mm256_shuffle_epi8(a, CONST256(KeccakP1600times8_rho8))
+    #define ROL64in256_56(d, a)     d = _mm256_shuffle_epi8(a, CONST256(KeccakP1600times8_rho56))
+static const UINT64 KeccakP1600times8_rho8[4] = {0x0605040302010007, 0x0E0D0C0B0A09080F, 0x1615141312111017, 0x1E1D1C1B1A19181F};
+static const UINT64 KeccakP1600times8_rho56[4] = {0x0007060504030201, 0x080F0E0D0C0B0A09, 0x1017161514131211, 0x181F1E1D1C1B1A19};
+#endif
+    #define STORE256(a, b)          _mm256_store_si256((V256 *)&(a), b)
+    #define STORE256u(a, b)         _mm256_storeu_si256((V256 *)&(a), b)
+    #define STORE2_128(ah, al, v)   _mm256_storeu2_m128d((V128*)&(ah), (V128*)&(al), v)
+    #define XOR256(a, b)            _mm256_xor_si256(a, b)
+    #define XOReq256(a, b)          a = _mm256_xor_si256(a, b)
+    #define UNPACKL( a, b )         _mm256_unpacklo_epi64((a), (b))
+    #define UNPACKH( a, b )         _mm256_unpackhi_epi64((a), (b))
+    #define PERM128( a, b, c )      (V256)_mm256_permute2f128_ps((__m256)(a), (__m256)(b), c)
+    #define SHUFFLE64( a, b, c )    (V256)_mm256_shuffle_pd((__m256d)(a), (__m256d)(b), c)
+
+    #define UNINTLEAVE()            lanesL01 = UNPACKL( lanes0, lanes1 ),                   \
+                                    lanesH01 = UNPACKH( lanes0, lanes1 ),                   \
+                                    lanesL23 = UNPACKL( lanes2, lanes3 ),                   \
+                                    lanesH23 = UNPACKH( lanes2, lanes3 ),                   \
+                                    lanes0 = PERM128( lanesL01, lanesL23, 0x20 ),           \
+                                    lanes2 = PERM128( lanesL01, lanesL23, 0x31 ),           \
+                                    lanes1 = PERM128( lanesH01, lanesH23, 0x20 ),           \
+                                    lanes3 = PERM128( lanesH01, lanesH23, 0x31 )
+
+    #define INTLEAVE()              lanesL01 = PERM128( lanes0, lanes2, 0x20 ),             \
+                                    lanesH01 = PERM128( lanes1, lanes3, 0x20 ),             \
+                                    lanesL23 = PERM128( lanes0, lanes2, 0x31 ),             \
+                                    lanesH23 = PERM128( lanes1, lanes3, 0x31 ),             \
+                                    lanes0 = SHUFFLE64( lanesL01, lanesH01, 0x00 ),         \
+                                    lanes1 = SHUFFLE64( lanesL01, lanesH01, 0x0F ),         \
+                                    lanes2 = SHUFFLE64( lanesL23, lanesH23, 0x00 ),         \
+                                    lanes3 = SHUFFLE64( lanesL23, lanesH23, 0x0F )
+
+#endif
+
+#if defined(KeccakP1600times8_prefetchDistance)
+/* Requests the 168 bytes that the instance reading at p absorbs KeccakP1600times8_prefetchDistance bytes later */
+#define PREFETCH_BLOCK(p) \
+    { \
+        const char *q = (const char *)(p) + KeccakP1600times8_prefetchDistance; \
+        _mm_prefetch(q, _MM_HINT_T0); \
+        _mm_prefetch(q + 64, _MM_HINT_T0); \
+        _mm_prefetch(q + 128, _MM_HINT_T0); \
+    }
+#else
+#define PREFETCH_BLOCK(p)
+#endif
+
+#define SnP_laneLengthInBytes 8
+
+void KeccakP1600times8_InitializeAll(void *states)
+{
+    memset(states, 0, KeccakP1600times8_statesSizeInBytes);
+}
+
+void KeccakP1600times8_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length)
+{
+    unsigned int sizeLeft = length;
+    unsigned int lanePosition = offset/SnP_laneLengthInBytes;
+    unsigned int offsetInLane = offset%SnP_laneLengthInBytes;
+    const unsigned char *curData = data;
+    UINT64 *statesAsLanes = (UINT64 *)states;
+
+    if ((sizeLeft > 0) && (offsetInLane != 0)) {
+        unsigned int bytesInLane = SnP_laneLengthInBytes - offsetInLane;
+        UINT64 lane = 0;
+        if (bytesInLane > sizeLeft)
+            bytesInLane = sizeLeft;
+        memcpy((unsigned char*)&lane + offsetInLane, curData, bytesInLane);
+        statesAsLanes[laneIndex(instanceIndex, lanePosition)] ^= lane;
+        sizeLeft -= bytesInLane;
+        lanePosition++;
+        curData += bytesInLane;
+    }
+
+    while(sizeLeft >= SnP_laneLengthInBytes) {
+        UINT64 lane = *((const UINT64*)curData);
+        statesAsLanes[laneIndex(instanceIndex, lanePosition)] ^= lane;
+        sizeLeft -= SnP_laneLengthInBytes;
+        lanePosition++;
+        curData += SnP_laneLengthInBytes;
+    }
+
+    if (sizeLeft > 0) {
+        UINT64 lane = 0;
+        memcpy(&lane, curData, sizeLeft);
+        statesAsLanes[laneIndex(instanceIndex, lanePosition)] ^= lane;
+    }
+}
+
+void KeccakP1600times8_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    V256 *stateAsLanes = (V256 *)states;
+    unsigned int i, s;
+    V256    lanes0, lanes1, lanes2, lanes3, lanesL01, lanesL23, lanesH01, lanesH23;
+
+    for(s=0; s<2; s++) {
+        const UINT64 *curData0 = (const UINT64 *)(data+laneOffset*(4*s+0)*SnP_laneLengthInBytes);
+        const UINT64 *curData1 = (const UINT64 *)(data+laneOffset*(4*s+1)*SnP_laneLengthInBytes);
+        const UINT64 *curData2 = (const UINT64 *)(data+laneOffset*(4*s+2)*SnP_laneLengthInBytes);
+        const UINT64 *curData3 = (const UINT64 *)(data+laneOffset*(4*s+3)*SnP_laneLengthInBytes);
+
+        #define Xor_In( argIndex )  XOReq256(stateAsLanes[2*(argIndex)+s], LOAD4_64(curData3[argIndex], curData2[argIndex], curData1[argIndex], curData0[argIndex]))
+
+        #define Xor_In4( argIndex ) lanes0 = LOAD256u( curData0[argIndex]),\
+                                    lanes1 = LOAD256u( curData1[argIndex]),\
+                                    lanes2 = LOAD256u( curData2[argIndex]),\
+                                    lanes3 = LOAD256u( curData3[argIndex]),\
+                                    INTLEAVE(),\
+                                    XOReq256( stateAsLanes[2*(argIndex+0)+s], lanes0 ),\
+                                    XOReq256( stateAsLanes[2*(argIndex+1)+s], lanes1 ),\
+                                    XOReq256( stateAsLanes[2*(argIndex+2)+s], lanes2 ),\
+                                    XOReq256( stateAsLanes[2*(argIndex+3)+s], lanes3 )
+
+        for(i=0; i+4<=laneCount; i+=4)
+            Xor_In4( i );
+        for(; i<laneCount; i++)
+            Xor_In( i );
+        #undef  Xor_In
+        #undef  Xor_In4
+    }
+}
+
+void KeccakP1600times8_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length)
+{
+    unsigned int sizeLeft = length;
+    unsigned int lanePosition = offset/SnP_laneLengthInBytes;
+    unsigned int offsetInLane = offset%SnP_laneLengthInBytes;
+    unsigned char *curData = data;
+    const UINT64 *statesAsLanes = (const UINT64 *)states;
+
+    if ((sizeLeft > 0) && (offsetInLane != 0)) {
+        unsigned int bytesInLane = SnP_laneLengthInBytes - offsetInLane;
+        if (bytesInLane > sizeLeft)
+            bytesInLane = sizeLeft;
+        memcpy( curData, ((unsigned char *)&statesAsLanes[laneIndex(instanceIndex, lanePosition)]) + offsetInLane, bytesInLane);
+        sizeLeft -= bytesInLane;
+        lanePosition++;
+        curData += bytesInLane;
+    }
+
+    while(sizeLeft >= SnP_laneLengthInBytes) {
+        *(UINT64*)curData = statesAsLanes[laneIndex(instanceIndex, lanePosition)];
+        sizeLeft -= SnP_laneLengthInBytes;
+        lanePosition++;
+        curData += SnP_laneLengthInBytes;
+    }
+
+    if (sizeLeft > 0) {
+        memcpy( curData, &statesAsLanes[laneIndex(instanceIndex, lanePosition)], sizeLeft);
+    }
+}
+
+void KeccakP1600times8_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    const V256 *stateAsLanes = (const V256 *)states;
+    const UINT64 *stateAsLanes64 = (const UINT64*)states;
+    unsigned int i, s;
+    V256    lanes0, lanes1, lanes2, lanes3, lanesL01, lanesL23, lanesH01, lanesH23;
+
+    for(s=0; s<2; s++) {
+        UINT64 *curData0 = (UINT64 *)(data+laneOffset*(4*s+0)*SnP_laneLengthInBytes);
+        UINT64 *curData1 = (UINT64 *)(data+laneOffset*(4*s+1)*SnP_laneLengthInBytes);
+        UINT64 *curData2 = (UINT64 *)(data+laneOffset*(4*s+2)*SnP_laneLengthInBytes);
+        UINT64 *curData3 = (UINT64 *)(data+laneOffset*(4*s+3)*SnP_laneLengthInBytes);
+
+        #define Extr( argIndex )    curData0[argIndex] = stateAsLanes64[8*(argIndex)+4*s],      \
+                                    curData1[argIndex] = stateAsLanes64[8*(argIndex)+4*s+1],    \
+                                    curData2[argIndex] = stateAsLanes64[8*(argIndex)+4*s+2],    \
+                                    curData3[argIndex] = stateAsLanes64[8*(argIndex)+4*s+3]
+
+        #define Extr4( argIndex )   lanes0 = LOAD256( stateAsLanes[2*(argIndex+0)+s] ),         \
+                                    lanes1 = LOAD256( stateAsLanes[2*(argIndex+1)+s] ),         \
+                                    lanes2 = LOAD256( stateAsLanes[2*(argIndex+2)+s] ),         \
+                                    lanes3 = LOAD256( stateAsLanes[2*(argIndex+3)+s] ),         \
+                                    UNINTLEAVE(),                                               \
+                                    STORE256u( curData0[argIndex], lanes0 ),                    \
+                                    STORE256u( curData1[argIndex], lanes1 ),                    \
+                                    STORE256u( curData2[argIndex], lanes2 ),                    \
+                                    STORE256u( curData3[argIndex], lanes3 )
+
+        for(i=0; i+4<=laneCount; i+=4)
+            Extr4( i );
+        for(; i<laneCount; i++)
+            Extr( i );
+        #undef  Extr
+        #undef  Extr4
+    }
+}
+
+#define declareABCDE(X) \
+    V256 X##Aba, X##Abe, X##Abi, X##Abo, X##Abu; \
+    V256 X##Aga, X##Age, X##Agi, X##Ago, X##Agu; \
+    V256 X##Aka, X##Ake, X##Aki, X##Ako, X##Aku; \
+    V256 X##Ama, X##Ame, X##Ami, X##Amo, X##Amu; \
+    V256 X##Asa, X##Ase, X##Asi, X##Aso, X##Asu; \
+    V256 X##Bba, X##Bbe, X##Bbi, X##Bbo, X##Bbu; \
+    V256 X##Bga, X##Bge, X##Bgi, X##Bgo, X##Bgu; \
+    V256 X##Bka, X##Bke, X##Bki, X##Bko, X##Bku; \
+    V256 X##Bma, X##Bme, X##Bmi, X##Bmo, X##Bmu; \
+    V256 X##Bsa, X##Bse, X##Bsi, X##Bso, X##Bsu; \
+    V256 X##Ca, X##Ce, X##Ci, X##Co, X##Cu; \
+    V256 X##Ca1, X##Ce1, X##Ci1, X##Co1, X##Cu1; \
+    V256 X##Da, X##De, X##Di, X##Do, X##Du; \
+    V256 X##Eba, X##Ebe, X##Ebi, X##Ebo, X##Ebu; \
+    V256 X##Ega, X##Ege, X##Egi, X##Ego, X##Egu; \
+    V256 X##Eka, X##Eke, X##Eki, X##Eko, X##Eku; \
+    V256 X##Ema, X##Eme, X##Emi, X##Emo, X##Emu; \
+    V256 X##Esa, X##Ese, X##Esi, X##Eso, X##Esu; \
+
+#define prepareTheta(X) \
+    X##Ca = XOR256(X##Aba, XOR256(X##Aga, XOR256(X##Aka, XOR256(X##Ama, X##Asa)))); \
+    X##Ce = XOR256(X##Abe, XOR256(X##Age, XOR256(X##Ake, XOR256(X##Ame, X##Ase)))); \
+    X##Ci = XOR256(X##Abi, XOR256(X##Agi, XOR256(X##Aki, XOR256(X##Ami, X##Asi)))); \
+    X##Co = XOR256(X##Abo, XOR256(X##Ago, XOR256(X##Ako, XOR256(X##Amo, X##Aso)))); \
+    X##Cu = XOR256(X##Abu, XOR256(X##Agu, XOR256(X##Aku, XOR256(X##Amu, X##Asu)))); \
+
+/* --- Theta Rho Pi Chi Iota Prepare-theta, split into the computation of D and the five output planes */
+/* --- 64-bit lanes mapped to 64-bit words */
+#define thetaD(X) \
+    ROL64in256(X##Ce1, X##Ce, 1); \
+    X##Da = XOR256(X##Cu, X##Ce1); \
+    ROL64in256(X##Ci1, X##Ci, 1); \
+    X##De = XOR256(X##Ca, X##Ci1); \
+    ROL64in256(X##Co1, X##Co, 1); \
+    X##Di = XOR256(X##Ce, X##Co1); \
+    ROL64in256(X##Cu1, X##Cu, 1); \
+    X##Do = XOR256(X##Ci, X##Cu1); \
+    ROL64in256(X##Ca1, X##Ca, 1); \
+    X##Du = XOR256(X##Co, X##Ca1);
+
+#define planeB(i, X, A, E) \
+    XOReq256(X##A##ba, X##Da); \
+    X##Bba = X##A##ba; \
+    XOReq256(X##A##ge, X##De); \
+    ROL64in256(X##Bbe, X##A##ge, 44); \
+    XOReq256(X##A##ki, X##Di); \
+    ROL64in256(X##Bbi, X##A##ki, 43); \
+    X##E##ba = CHI256(X##Bba, X##Bbe, X##Bbi); \
+    XOReq256(X##E##ba, CONST256_64(KeccakP1600times8_RoundConstants[i])); \
+    X##Ca = X##E##ba; \
+    XOReq256(X##A##mo, X##Do); \
+    ROL64in256(X##Bbo, X##A##mo, 21); \
+    X##E##be = CHI256(X##Bbe, X##Bbi, X##Bbo); \
+    X##Ce = X##E##be; \
+    XOReq256(X##A##su, X##Du); \
+    ROL64in256(X##Bbu, X##A##su, 14); \
+    X##E##bi = CHI256(X##Bbi, X##Bbo, X##Bbu); \
+    X##Ci = X##E##bi; \
+    X##E##bo = CHI256(X##Bbo, X##Bbu, X##Bba); \
+    X##Co = X##E##bo; \
+    X##E##bu = CHI256(X##Bbu, X##Bba, X##Bbe); \
+    X##Cu = X##E##bu;
+
+#define planeG(X, A, E) \
+    XOReq256(X##A##bo, X##Do); \
+    ROL64in256(X##Bga, X##A##bo, 28); \
+    XOReq256(X##A##gu, X##Du); \
+    ROL64in256(X##Bge, X##A##gu, 20); \
+    XOReq256(X##A##ka, X##Da); \
+    ROL64in256(X##Bgi, X##A##ka, 3); \
+    X##E##ga = CHI256(X##Bga, X##Bge, X##Bgi); \
+    XOReq256(X##Ca, X##E##ga); \
+    XOReq256(X##A##me, X##De); \
+    ROL64in256(X##Bgo, X##A##me, 45); \
+    X##E##ge = CHI256(X##Bge, X##Bgi, X##Bgo); \
+    XOReq256(X##Ce, X##E##ge); \
+    XOReq256(X##A##si, X##Di); \
+    ROL64in256(X##Bgu, X##A##si, 61); \
+    X##E##gi = CHI256(X##Bgi, X##Bgo, X##Bgu); \
+    XOReq256(X##Ci, X##E##gi); \
+    X##E##go = CHI256(X##Bgo, X##Bgu, X##Bga); \
+    XOReq256(X##Co, X##E##go); \
+    X##E##gu = CHI256(X##Bgu, X##Bga, X##Bge); \
+    XOReq256(X##Cu, X##E##gu);
+
+#define planeK(X, A, E) \
+    XOReq256(X##A##be, X##De); \
+    ROL64in256(X##Bka, X##A##be, 1); \
+    XOReq256(X##A##gi, X##Di); \
+    ROL64in256(X##Bke, X##A##gi, 6); \
+    XOReq256(X##A##ko, X##Do); \
+    ROL64in256(X##Bki, X##A##ko, 25); \
+    X##E##ka = CHI256(X##Bka, X##Bke, X##Bki); \
+    XOReq256(X##Ca, X##E##ka); \
+    XOReq256(X##A##mu, X##Du); \
+    ROL64in256_8(X##Bko, X##A##mu); \
+    X##E##ke = CHI256(X##Bke, X##Bki, X##Bko); \
+    XOReq256(X##Ce, X##E##ke); \
+    XOReq256(X##A##sa, X##Da); \
+    ROL64in256(X##Bku, X##A##sa, 18); \
+    X##E##ki = CHI256(X##Bki, X##Bko, X##Bku); \
+    XOReq256(X##Ci, X##E##ki); \
+    X##E##ko = CHI256(X##Bko, X##Bku, X##Bka); \
+    XOReq256(X##Co, X##E##ko); \
+    X##E##ku = CHI256(X##Bku, X##Bka, X##Bke); \
+    XOReq256(X##Cu, X##E##ku);
+
+#define planeM(X, A, E) \
+    XOReq256(X##A##bu, X##Du); \
+    ROL64in256(X##Bma, X##A##bu, 27); \
+    XOReq256(X##A##ga, X##Da); \
+    ROL64in256(X##Bme, X##A##ga, 36); \
+    XOReq256(X##A##ke, X##De); \
+    ROL64in256(X##Bmi, X##A##ke, 10); \
+    X##E##ma = CHI256(X##Bma, X##Bme, X##Bmi); \
+    XOReq256(X##Ca, X##E##ma); \
+    XOReq256(X##A##mi, X##Di); \
+    ROL64in256(X##Bmo, X##A##mi, 15); \
+    X##E##me = CHI256(X##Bme, X##Bmi, X##Bmo); \
+    XOReq256(X##Ce, X##E##me); \
+    XOReq256(X##A##so, X##Do); \
+    ROL64in256_56(X##Bmu, X##A##so); \
+    X##E##mi = CHI256(X##Bmi, X##Bmo, X##Bmu); \
+    XOReq256(X##Ci, X##E##mi); \
+    X##E##mo = CHI256(X##Bmo, X##Bmu, X##Bma); \
+    XOReq256(X##Co, X##E##mo); \
+    X##E##mu = CHI256(X##Bmu, X##Bma, X##Bme); \
+    XOReq256(X##Cu, X##E##mu);
+
+#define planeS(X, A, E) \
+    XOReq256(X##A##bi, X##Di); \
+    ROL64in256(X##Bsa, X##A##bi, 62); \
+    XOReq256(X##A##go, X##Do); \
+    ROL64in256(X##Bse, X##A##go, 55); \
+    XOReq256(X##A##ku, X##Du); \
+    ROL64in256(X##Bsi, X##A##ku, 39); \
+    X##E##sa = CHI256(X##Bsa, X##Bse, X##Bsi); \
+    XOReq256(X##Ca, X##E##sa); \
+    XOReq256(X##A##ma, X##Da); \
+    ROL64in256(X##Bso, X##A##ma, 41); \
+    X##E##se = CHI256(X##Bse, X##Bsi, X##Bso); \
+    XOReq256(X##Ce, X##E##se); \
+    XOReq256(X##A##se, X##De); \
+    ROL64in256(X##Bsu, X##A##se, 2); \
+    X##E##si = CHI256(X##Bsi, X##Bso, X##Bsu); \
+    XOReq256(X##Ci, X##E##si); \
+    X##E##so = CHI256(X##Bso, X##Bsu, X##Bsa); \
+    XOReq256(X##Co, X##E##so); \
+    X##E##su = CHI256(X##Bsu, X##Bsa, X##Bse); \
+    XOReq256(X##Cu, X##E##su);
+
+/* The last round also prepares theta, the compiler removes what is not used */
+#define roundTimes2(i, A, E) \
+    thetaD(X) \
+    thetaD(Y) \
+    planeB(i, X, A, E) \
+    planeB(i, Y, A, E) \
+    planeG(X, A, E) \
+    planeG(Y, A, E) \
+    planeK(X, A, E) \
+    planeK(Y, A, E) \
+    planeM(X, A, E) \
+    planeM(Y, A, E) \
+    planeS(X, A, E) \
+    planeS(Y, A, E) \
+
+#define rounds12 \
+    prepareTheta(X) \
+    prepareTheta(Y) \
+    roundTimes2(12, A, E) \
+    roundTimes2(13, E, A) \
+    roundTimes2(14, A, E) \
+    roundTimes2(15, E, A) \
+    roundTimes2(16, A, E) \
+    roundTimes2(17, E, A) \
+    roundTimes2(18, A, E) \
+    roundTimes2(19, E, A) \
+    roundTimes2(20, A, E) \
+    roundTimes2(21, E, A) \
+    roundTimes2(22, A, E) \
+    roundTimes2(23, E, A) \
+
+static ALIGN(KeccakP1600times8_statesAlignment) const UINT64 KeccakP1600times8_RoundConstants[24] = {
+    0x0000000000000001ULL,
+    0x0000000000008082ULL,
+    0x800000000000808aULL,
+    0x8000000080008000ULL,
+    0x000000000000808bULL,
+    0x0000000080000001ULL,
+    0x8000000080008081ULL,
+    0x8000000000008009ULL,
+    0x000000000000008aULL,
+    0x0000000000000088ULL,
+    0x0000000080008009ULL,
+    0x000000008000000aULL,
+    0x000000008000808bULL,
+    0x800000000000008bULL,
+    0x8000000000008089ULL,
+    0x8000000000008003ULL,
+    0x8000000000008002ULL,
+    0x8000000000000080ULL,
+    0x000000000000800aULL,
+    0x800000008000000aULL,
+    0x8000000080008081ULL,
+    0x8000000000008080ULL,
+    0x0000000080000001ULL,
+    0x8000000080008008ULL};
+
+/* Set s of the states, i.e. instances 4*s to 4*s+3, is in the even (s = 0) or odd (s = 1) 256-bit words */
+#define copyFromState(X, state, s) \
+    X##Aba = LOAD256(state[2* 0+(s)]); \
+    X##Abe = LOAD256(state[2* 1+(s)]); \
+    X##Abi = LOAD256(state[2* 2+(s)]); \
+    X##Abo = LOAD256(state[2* 3+(s)]); \
+    X##Abu = LOAD256(state[2* 4+(s)]); \
+    X##Aga = LOAD256(state[2* 5+(s)]); \
+    X##Age = LOAD256(state[2* 6+(s)]); \
+    X##Agi = LOAD256(state[2* 7+(s)]); \
+    X##Ago = LOAD256(state[2* 8+(s)]); \
+    X##Agu = LOAD256(state[2* 9+(s)]); \
+    X##Aka = LOAD256(state[2*10+(s)]); \
+    X##Ake = LOAD256(state[2*11+(s)]); \
+    X##Aki = LOAD256(state[2*12+(s)]); \
+    X##Ako = LOAD256(state[2*13+(s)]); \
+    X##Aku = LOAD256(state[2*14+(s)]); \
+    X##Ama = LOAD256(state[2*15+(s)]); \
+    X##Ame = LOAD256(state[2*16+(s)]); \
+    X##Ami = LOAD256(state[2*17+(s)]); \
+    X##Amo = LOAD256(state[2*18+(s)]); \
+    X##Amu = LOAD256(state[2*19+(s)]); \
+    X##Asa = LOAD256(state[2*20+(s)]); \
+    X##Ase = LOAD256(state[2*21+(s)]); \
+    X##Asi = LOAD256(state[2*22+(s)]); \
+    X##Aso = LOAD256(state[2*23+(s)]); \
+    X##Asu = LOAD256(state[2*24+(s)]); \
+
+#define copyToState(state, s, X) \
+    STORE256(state[2* 0+(s)], X##Aba); \
+    STORE256(state[2* 1+(s)], X##Abe); \
+    STORE256(state[2* 2+(s)], X##Abi); \
+    STORE256(state[2* 3+(s)], X##Abo); \
+    STORE256(state[2* 4+(s)], X##Abu); \
+    STORE256(state[2* 5+(s)], X##Aga); \
+    STORE256(state[2* 6+(s)], X##Age); \
+    STORE256(state[2* 7+(s)], X##Agi); \
+    STORE256(state[2* 8+(s)], X##Ago); \
+    STORE256(state[2* 9+(s)], X##Agu); \
+    STORE256(state[2*10+(s)], X##Aka); \
+    STORE256(state[2*11+(s)], X##Ake); \
+    STORE256(state[2*12+(s)], X##Aki); \
+    STORE256(state[2*13+(s)], X##Ako); \
+    STORE256(state[2*14+(s)], X##Aku); \
+    STORE256(state[2*15+(s)], X##Ama); \
+    STORE256(state[2*16+(s)], X##Ame); \
+    STORE256(state[2*17+(s)], X##Ami); \
+    STORE256(state[2*18+(s)], X##Amo); \
+    STORE256(state[2*19+(s)], X##Amu); \
+    STORE256(state[2*20+(s)], X##Asa); \
+    STORE256(state[2*21+(s)], X##Ase); \
+    STORE256(state[2*22+(s)], X##Asi); \
+    STORE256(state[2*23+(s)], X##Aso); \
+    STORE256(state[2*24+(s)], X##Asu); \
+
+void KeccakP1600times8_PermuteAll_12rounds(void *states)
+{
+    V256 *statesAsLanes = (V256 *)states;
+    declareABCDE(X)
+    declareABCDE(Y)
+
+    copyFromState(X, statesAsLanes, 0)
+    copyFromState(Y, statesAsLanes, 1)
+    rounds12
+    copyToState(statesAsLanes, 0, X)
+    copyToState(statesAsLanes, 1, Y)
+}
+
+#define XOR_In( Xxx, Yxx, argIndex ) \
+    XOReq256(Xxx, LOAD4_64(curData3[argIndex], curData2[argIndex], curData1[argIndex], curData0[argIndex])); \
+    XOReq256(Yxx, LOAD4_64(curData7[argIndex], curData6[argIndex], curData5[argIndex], curData4[argIndex]))
+
+size_t KeccakP1600times8_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen)
+{
+    if (laneCount == 21) {
+        const unsigned char *dataStart = data;
+        const UINT64 *curData0 = (const UINT64 *)(data+laneOffsetParallel*0*SnP_laneLengthInBytes);
+        const UINT64 *curData1 = (const UINT64 *)(data+laneOffsetParallel*1*SnP_laneLengthInBytes);
+        const UINT64 *curData2 = (const UINT64 *)(data+laneOffsetParallel*2*SnP_laneLengthInBytes);
+        const UINT64 *curData3 = (const UINT64 *)(data+laneOffsetParallel*3*SnP_laneLengthInBytes);
+        const UINT64 *curData4 = (const UINT64 *)(data+laneOffsetParallel*4*SnP_laneLengthInBytes);
+        const UINT64 *curData5 = (const UINT64 *)(data+laneOffsetParallel*5*SnP_laneLengthInBytes);
+        const UINT64 *curData6 = (const UINT64 *)(data+laneOffsetParallel*6*SnP_laneLengthInBytes);
+        const UINT64 *curData7 = (const UINT64 *)(data+laneOffsetParallel*7*SnP_laneLengthInBytes);
+        V256 *statesAsLanes = states;
+        declareABCDE(X)
+        declareABCDE(Y)
+
+        copyFromState(X, statesAsLanes, 0)
+        copyFromState(Y, statesAsLanes, 1)
+        while(dataByteLen >= (laneOffsetParallel*7 + laneCount)*8) {
+            PREFETCH_BLOCK(curData0)
+            PREFETCH_BLOCK(curData1)
+            PREFETCH_BLOCK(curData2)
+            PREFETCH_BLOCK(curData3)
+            PREFETCH_BLOCK(curData4)
+            PREFETCH_BLOCK(curData5)
+            PREFETCH_BLOCK(curData6)
+            PREFETCH_BLOCK(curData7)
+            XOR_In( XAba, YAba, 0 );
+            XOR_In( XAbe, YAbe, 1 );
+            XOR_In( XAbi, YAbi, 2 );
+            XOR_In( XAbo, YAbo, 3 );
+            XOR_In( XAbu, YAbu, 4 );
+            XOR_In( XAga, YAga, 5 );
+            XOR_In( XAge, YAge, 6 );
+            XOR_In( XAgi, YAgi, 7 );
+            XOR_In( XAgo, YAgo, 8 );
+            XOR_In( XAgu, YAgu, 9 );
+            XOR_In( XAka, YAka, 10 );
+            XOR_In( XAke, YAke, 11 );
+            XOR_In( XAki, YAki, 12 );
+            XOR_In( XAko, YAko, 13 );
+            XOR_In( XAku, YAku, 14 );
+            XOR_In( XAma, YAma, 15 );
+            XOR_In( XAme, YAme, 16 );
+            XOR_In( XAmi, YAmi, 17 );
+            XOR_In( XAmo, YAmo, 18 );
+            XOR_In( XAmu, YAmu, 19 );
+            XOR_In( XAsa, YAsa, 20 );
+            rounds12
+            curData0 += laneOffsetSerial;
+            curData1 += laneOffsetSerial;
+            curData2 += laneOffsetSerial;
+            curData3 += laneOffsetSerial;
+            curData4 += laneOffsetSerial;
+            curData5 += laneOffsetSerial;
+            curData6 += laneOffsetSerial;
+            curData7 += laneOffsetSerial;
+            dataByteLen -= laneOffsetSerial*8;
+        }
+        copyToState(statesAsLanes, 0, X)
+        copyToState(statesAsLanes, 1, Y)
+        return (const unsigned char *)curData0 - dataStart;
+    }
+    else {
+        const unsigned char *dataStart = data;
+
+        while(dataByteLen >= (laneOffsetParallel*7 + laneCount)*8) {
+            KeccakP1600times8_AddLanesAll(states, data, laneCount, laneOffsetParallel);
+            KeccakP1600times8_PermuteAll_12rounds(states);
+            data += laneOffsetSerial*8;
+            dataByteLen -= laneOffsetSerial*8;
+        }
+        return data - dataStart;
+    }
+}
+
+/* KangarooTwelve leaves: 8192 bytes = 48 blocks of 21 lanes + 16 lanes, suffix 0x0B, 32-byte chaining values */
+#define LeafCVs_chunkLanes      (8192/8)
+#define LeafCVs_fullBlocks      (8192/168)
+
+/*
+Instances beyond leafCount hash the first leaf again instead of reading past the input,
+and only the chaining values of the first leafCount instances are written.
+*/
+static void LeafCVs(const unsigned char *data, unsigned int leafCount, unsigned char *chainingValues)
+{
+    const UINT64 *curData0 = (const UINT64 *)data;
+    const UINT64 *curData1 = (const UINT64 *)data + ((1 < leafCount) ? 1 : 0)*LeafCVs_chunkLanes;
+    const UINT64 *curData2 = (const UINT64 *)data + ((2 < leafCount) ? 2 : 0)*LeafCVs_chunkLanes;
+    const UINT64 *curData3 = (const UINT64 *)data + ((3 < leafCount) ? 3 : 0)*LeafCVs_chunkLanes;
+    const UINT64 *curData4 = (const UINT64 *)data + ((4 < leafCount) ? 4 : 0)*LeafCVs_chunkLanes;
+    const UINT64 *curData5 = (const UINT64 *)data + ((5 < leafCount) ? 5 : 0)*LeafCVs_chunkLanes;
+    const UINT64 *curData6 = (const UINT64 *)data + ((6 < leafCount) ? 6 : 0)*LeafCVs_chunkLanes;
+    const UINT64 *curData7 = (const UINT64 *)data + ((7 < leafCount) ? 7 : 0)*LeafCVs_chunkLanes;
+    UINT64 *cvsAsLanes = (UINT64 *)chainingValues;
+    const UINT64 suffix = 0x0B;
+    const UINT64 padding = 0x8000000000000000ULL;
+    V256 lanes0, lanes1, lanes2, lanes3, lanesL01, lanesL23, lanesH01, lanesH23;
+    unsigned int j;
+    declareABCDE(X)
+    declareABCDE(Y)
+
+    XAba = XAbe = XAbi = XAbo = XAbu = _mm256_setzero_si256();
+    XAga = XAge = XAgi = XAgo = XAgu = _mm256_setzero_si256();
+    XAka = XAke = XAki = XAko = XAku = _mm256_setzero_si256();
+    XAma = XAme = XAmi = XAmo = XAmu = _mm256_setzero_si256();
+    XAsa = XAse = XAsi = XAso = XAsu = _mm256_setzero_si256();
+    YAba = YAbe = YAbi = YAbo = YAbu = _mm256_setzero_si256();
+    YAga = YAge = YAgi = YAgo = YAgu = _mm256_setzero_si256();
+    YAka = YAke = YAki = YAko = YAku = _mm256_setzero_si256();
+    YAma = YAme = YAmi = YAmo = YAmu = _mm256_setzero_si256();
+    YAsa = YAse = YAsi = YAso = YAsu = _mm256_setzero_si256();
+
+    for(j=0; j<LeafCVs_fullBlocks; j++) {
+        PREFETCH_BLOCK(curData0)
+        PREFETCH_BLOCK(curData1)
+        PREFETCH_BLOCK(curData2)
+        PREFETCH_BLOCK(curData3)
+        PREFETCH_BLOCK(curData4)
+        PREFETCH_BLOCK(curData5)
+        PREFETCH_BLOCK(curData6)
+        PREFETCH_BLOCK(curData7)
+        XOR_In( XAba, YAba, 0 );
+        XOR_In( XAbe, YAbe, 1 );
+        XOR_In( XAbi, YAbi, 2 );
+        XOR_In( XAbo, YAbo, 3 );
+        XOR_In( XAbu, YAbu, 4 );
+        XOR_In( XAga, YAga, 5 );
+        XOR_In( XAge, YAge, 6 );
+        XOR_In( XAgi, YAgi, 7 );
+        XOR_In( XAgo, YAgo, 8 );
+        XOR_In( XAgu, YAgu, 9 );
+        XOR_In( XAka, YAka, 10 );
+        XOR_In( XAke, YAke, 11 );
+        XOR_In( XAki, YAki, 12 );
+        XOR_In( XAko, YAko, 13 );
+        XOR_In( XAku, YAku, 14 );
+        XOR_In( XAma, YAma, 15 );
+        XOR_In( XAme, YAme, 16 );
+        XOR_In( XAmi, YAmi, 17 );
+        XOR_In( XAmo, YAmo, 18 );
+        XOR_In( XAmu, YAmu, 19 );
+        XOR_In( XAsa, YAsa, 20 );
+        rounds12
+        curData0 += 21;
+        curData1 += 21;
+        curData2 += 21;
+        curData3 += 21;
+        curData4 += 21;
+        curData5 += 21;
+        curData6 += 21;
+        curData7 += 21;
+    }
+
+    /* Last block: 16 lanes of data, then the suffix and the padding */
+    XOR_In( XAba, YAba, 0 );
+    XOR_In( XAbe, YAbe, 1 );
+    XOR_In( XAbi, YAbi, 2 );
+    XOR_In( XAbo, YAbo, 3 );
+    XOR_In( XAbu, YAbu, 4 );
+    XOR_In( XAga, YAga, 5 );
+    XOR_In( XAge, YAge, 6 );
+    XOR_In( XAgi, YAgi, 7 );
+    XOR_In( XAgo, YAgo, 8 );
+    XOR_In( XAgu, YAgu, 9 );
+    XOR_In( XAka, YAka, 10 );
+    XOR_In( XAke, YAke, 11 );
+    XOR_In( XAki, YAki, 12 );
+    XOR_In( XAko, YAko, 13 );
+    XOR_In( XAku, YAku, 14 );
+    XOR_In( XAma, YAma, 15 );
+    XOReq256(XAme, CONST256_64(suffix));
+    XOReq256(YAme, CONST256_64(suffix));
+    XOReq256(XAsa, CONST256_64(padding));
+    XOReq256(YAsa, CONST256_64(padding));
+    rounds12
+
+    /* The chaining values are the first 4 lanes of each instance */
+    lanes0 = XAba;
+    lanes1 = XAbe;
+    lanes2 = XAbi;
+    lanes3 = XAbo;
+    UNINTLEAVE();
+    if (leafCount == 8) {
+        STORE256u( cvsAsLanes[0], lanes0 );
+        STORE256u( cvsAsLanes[4], lanes1 );
+        STORE256u( cvsAsLanes[8], lanes2 );
+        STORE256u( cvsAsLanes[12], lanes3 );
+        lanes0 = YAba;
+        lanes1 = YAbe;
+        lanes2 = YAbi;
+        lanes3 = YAbo;
+        UNINTLEAVE();
+        STORE256u( cvsAsLanes[16], lanes0 );
+        STORE256u( cvsAsLanes[20], lanes1 );
+        STORE256u( cvsAsLanes[24], lanes2 );
+        STORE256u( cvsAsLanes[28], lanes3 );
+    }
+    else {
+        V256 cvs[8];
+
+        cvs[0] = lanes0;
+        cvs[1] = lanes1;
+        cvs[2] = lanes2;
+        cvs[3] = lanes3;
+        lanes0 = YAba;
+        lanes1 = YAbe;
+        lanes2 = YAbi;
+        lanes3 = YAbo;
+        UNINTLEAVE();
+        cvs[4] = lanes0;
+        cvs[5] = lanes1;
+        cvs[6] = lanes2;
+        cvs[7] = lanes3;
+        for(j=0; j<leafCount; j++)
+            STORE256u( cvsAsLanes[4*j], cvs[j] );
+    }
+}
+
+#undef XOR_In
+
+void KeccakP1600times8_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues)
+{
+    LeafCVs(data, 8, chainingValues);
+}
+
+void KeccakP1600times8_12rounds_PartialLeafCVs(const unsigned char *data, unsigned int leafCount, unsigned char *chainingValues)
+{
+    LeafCVs(data, leafCount, chainingValues);
+}
+
+#endif
+
+/* Out of the way of the other parallel sources of a single translation unit, AVX-512VL ones included */
+#undef laneIndex
+#undef UNPACKL
+#undef UNPACKH
+#undef declareABCDE
+#undef prepareTheta
+#undef copyFromState
+#undef copyToState
+#undef rounds12
@@ -53,6 +53,7 @@ size_t KeccakP1600times2_12rounds_FastLoop_Absorb(void *states, unsigned int lan
 #define KeccakP1600times4_statesSizeInBytes     800
 #define KeccakP1600times4_statesAlignment       64
 #define KeccakP1600times4_12rounds_FastLoop_supported
+#define KeccakP1600times4_12rounds_LeafCVs_supported
 
 #define KeccakP1600times4_StaticInitialize()
 void KeccakP1600times4_InitializeAll(void *states);
@@ -64,11 +65,15 @@ void KeccakP1600times4_PermuteAll_12rounds(void *states);
 void KeccakP1600times4_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
 void KeccakP1600times4_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
 size_t KeccakP1600times4_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+/* Hashes N consecutive KangarooTwelve leaves of 8192 bytes and writes their N chaining values of 32 bytes consecutively. */
+void KeccakP1600times4_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues);
 
 #define KeccakP1600times8_implementation        "512-bit SIMD implementation (" KeccakP1600times8_implementation_config ")"
 #define KeccakP1600times8_statesSizeInBytes     1600
 #define KeccakP1600times8_statesAlignment       64
 #define KeccakP1600times8_12rounds_FastLoop_supported
+#define KeccakP1600times8_12rounds_LeafCVs_supported
+#define KeccakP1600times8_12rounds_PartialLeafCVs_supported
 
 #define KeccakP1600times8_StaticInitialize()
 void KeccakP1600times8_InitializeAll(void *states);
@@ -80,5 +85,27 @@ void KeccakP1600times8_PermuteAll_12rounds(void *states);
 void KeccakP1600times8_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
 void KeccakP1600times8_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
 size_t KeccakP1600times8_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+/* Hashes N consecutive KangarooTwelve leaves of 8192 bytes and writes their N chaining values of 32 bytes consecutively. */
+void KeccakP1600times8_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues);
+/* Same as KeccakP1600times8_12rounds_LeafCVs() for 1 to 8 leaves, using masked instances. */
+void KeccakP1600times8_12rounds_PartialLeafCVs(const unsigned char *data, unsigned int leafCount, unsigned char *chainingValues);
+
+#if defined(KeccakP1600times16_interleavedTimes8)
+#define KeccakP1600times16_implementation       "512-bit SIMD implementation (" KeccakP1600times16_implementation_config ")"
+#define KeccakP1600times16_statesSizeInBytes    3200
+#define KeccakP1600times16_statesAlignment      64
+#define KeccakP1600times16_12rounds_FastLoop_supported
+
+#define KeccakP1600times16_StaticInitialize()
+void KeccakP1600times16_InitializeAll(void *states);
+#define KeccakP1600times16_AddByte(states, instanceIndex, byte, offset) \
+    ((unsigned char*)(states))[((instanceIndex)/8)*1600 + ((instanceIndex)%8)*8 + ((offset)/8)*8*8 + (offset)%8] ^= (byte)
+void KeccakP1600times16_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times16_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+void KeccakP1600times16_PermuteAll_12rounds(void *states);
+void KeccakP1600times16_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length);
+void KeccakP1600times16_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset);
+size_t KeccakP1600times16_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen);
+#endif
 
 #endif
@@ -5,7 +5,24 @@
 #define KeccakP1600times4_implementation_config "AVX512, 12 rounds unrolled"
 #define KeccakP1600times4_fullUnrolling
 #define KeccakP1600times4_useAVX512
+/*
+#define KeccakP1600times4_prefetchDistance 512
+*/
 
 #define KeccakP1600times8_implementation_config "AVX512, 12 rounds unrolled"
 #define KeccakP1600times8_fullUnrolling
 #define KeccakP1600times8_useAVX512
+#define KeccakP1600times8_useTransposedLoads
+#define KeccakP1600times8_useTransposedStores
+/* Distance in bytes at which the input of each instance is prefetched, for inputs coming from memory. */
+/* About 3 blocks ahead measured best on inputs out of the caches, 1024 and more slower than none. */
+#define KeccakP1600times8_prefetchDistance 512
+
+/* In addition, sixteen instances as two sets of eight with their rounds interleaved. */
+/* Measured end to end, it is at best 1.5% faster on inputs in the cache and about 20% slower on inputs out of it, */
+/* as it spills and does not prefetch, hence not enabled by default. */
+/*
+#define KeccakP1600times16_interleavedTimes8
+*/
+#define KeccakP1600times16_implementation_config "AVX512, two interleaved sets of 8, 12 rounds unrolled"
+#define KeccakP1600times16_useAVX512
@@ -0,0 +1,362 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#include <immintrin.h>
+#include <emmintrin.h>
+#include "KeccakP-1600-SnP.h"
+
+#include "brg_endian.h"
+#if (PLATFORM_BYTE_ORDER != IS_LITTLE_ENDIAN)
+#error Expecting a little-endian platform
+#endif
+
+#if defined(KeccakP1600times16_interleavedTimes8)
+
+#ifdef ALIGN
+#undef ALIGN
+#endif
+
+#if defined(__GNUC__)
+#define ALIGN(x) __attribute__ ((aligned(x)))
+#elif defined(_MSC_VER)
+#define ALIGN(x) __declspec(align(x))
+#elif defined(__ARMCC_VERSION)
+#define ALIGN(x) __align(x)
+#else
+#define ALIGN(x)
+#endif
+
+typedef __m256i     V256;
+typedef __m512i     V512;
+
+/*
+Sixteen instances as two consecutive sets of eight, each in the layout of the 8-way implementation.
+The lanes of both sets stay in registers and their rounds are interleaved step by step,
+so that two independent dependency chains are in flight instead of one.
+*/
+
+#if defined(KeccakP1600times16_useAVX512)
+
+#define XOR(a,b)                    _mm512_xor_si512(a,b)
+#define XOR3(a,b,c)                 _mm512_ternarylogic_epi64(a,b,c,0x96)
+#define XOR5(a,b,c,d,e)             XOR3(XOR3(a,b,c),d,e)
+#define ROL(a,offset)               _mm512_rol_epi64(a,offset)
+#define Chi(a,b,c)                  _mm512_ternarylogic_epi64(a,b,c,0xD2)
+#define CONST8_64(a)                (V512)_mm512_broadcast_f64x4(_mm256_broadcast_sd((const double*)(&a)))
+#define LOAD_MASK8_64(m,p)          _mm512_maskz_loadu_epi64( m, (const void*)(p))
+
+#endif
+
+/* Transposes the 8x8 matrix of lanes r0 to r7 with unpacks and 128-bit shuffles */
+#define TRANSPOSE8x8_64(r0, r1, r2, r3, r4, r5, r6, r7) \
+    { \
+        V512 t0, t1, t2, t3, t4, t5, t6, t7; \
+        t0 = _mm512_unpacklo_epi64(r0, r1); \
+        t1 = _mm512_unpackhi_epi64(r0, r1); \
+        t2 = _mm512_unpacklo_epi64(r2, r3); \
+        t3 = _mm512_unpackhi_epi64(r2, r3); \
+        t4 = _mm512_unpacklo_epi64(r4, r5); \
+        t5 = _mm512_unpackhi_epi64(r4, r5); \
+        t6 = _mm512_unpacklo_epi64(r6, r7); \
+        t7 = _mm512_unpackhi_epi64(r6, r7); \
+        r0 = _mm512_shuffle_i64x2(t0, t2, 0x88); \
+        r1 = _mm512_shuffle_i64x2(t0, t2, 0xDD); \
+        r2 = _mm512_shuffle_i64x2(t4, t6, 0x88); \
+        r3 = _mm512_shuffle_i64x2(t4, t6, 0xDD); \
+        r4 = _mm512_shuffle_i64x2(t1, t3, 0x88); \
+        r5 = _mm512_shuffle_i64x2(t1, t3, 0xDD); \
+        r6 = _mm512_shuffle_i64x2(t5, t7, 0x88); \
+        r7 = _mm512_shuffle_i64x2(t5, t7, 0xDD); \
+        t0 = _mm512_shuffle_i64x2(r0, r2, 0x88); \
+        t4 = _mm512_shuffle_i64x2(r0, r2, 0xDD); \
+        t2 = _mm512_shuffle_i64x2(r1, r3, 0x88); \
+        t6 = _mm512_shuffle_i64x2(r1, r3, 0xDD); \
+        t1 = _mm512_shuffle_i64x2(r4, r6, 0x88); \
+        t5 = _mm512_shuffle_i64x2(r4, r6, 0xDD); \
+        t3 = _mm512_shuffle_i64x2(r5, r7, 0x88); \
+        t7 = _mm512_shuffle_i64x2(r5, r7, 0xDD); \
+        r0 = t0; r1 = t1; r2 = t2; r3 = t3; r4 = t4; r5 = t5; r6 = t6; r7 = t7; \
+    }
+
+/* XORs lanes p[0..7] of 8 instances, stride lanes apart, into L0 to L7; the lanes outside rowMask read as zero */
+#define ADD_TRANSPOSED8_64(L0, L1, L2, L3, L4, L5, L6, L7, p, stride, rowMask) \
+    { \
+        V512 r0, r1, r2, r3, r4, r5, r6, r7; \
+        r0 = LOAD_MASK8_64(rowMask, (p)+0*(stride)); \
+        r1 = LOAD_MASK8_64(rowMask, (p)+1*(stride)); \
+        r2 = LOAD_MASK8_64(rowMask, (p)+2*(stride)); \
+        r3 = LOAD_MASK8_64(rowMask, (p)+3*(stride)); \
+        r4 = LOAD_MASK8_64(rowMask, (p)+4*(stride)); \
+        r5 = LOAD_MASK8_64(rowMask, (p)+5*(stride)); \
+        r6 = LOAD_MASK8_64(rowMask, (p)+6*(stride)); \
+        r7 = LOAD_MASK8_64(rowMask, (p)+7*(stride)); \
+        TRANSPOSE8x8_64(r0, r1, r2, r3, r4, r5, r6, r7) \
+        L0 = XOR(L0, r0); \
+        L1 = XOR(L1, r1); \
+        L2 = XOR(L2, r2); \
+        L3 = XOR(L3, r3); \
+        L4 = XOR(L4, r4); \
+        L5 = XOR(L5, r5); \
+        L6 = XOR(L6, r6); \
+        L7 = XOR(L7, r7); \
+    }
+
+/* Blocks of 21 lanes of the set X, in 8 + 8 + 5 lanes */
+#define ADD_TRANSPOSED21_64(X, p, stride) \
+    ADD_TRANSPOSED8_64(X##ba, X##be, X##bi, X##bo, X##bu, X##ga, X##ge, X##gi, (p)+0, stride, 0xFF) \
+    ADD_TRANSPOSED8_64(X##go, X##gu, X##ka, X##ke, X##ki, X##ko, X##ku, X##ma, (p)+8, stride, 0xFF) \
+    { \
+        V512 unused5 = _mm512_setzero_si512(), unused6 = unused5, unused7 = unused5; \
+        ADD_TRANSPOSED8_64(X##me, X##mi, X##mo, X##mu, X##sa, unused5, unused6, unused7, (p)+16, stride, 0x1F) \
+    }
+
+#define SnP_laneLengthInBytes                   8
+#define stateSetSize                            KeccakP1600times8_statesSizeInBytes
+
+void KeccakP1600times16_InitializeAll(void *states)
+{
+    memset(states, 0, KeccakP1600times16_statesSizeInBytes);
+}
+
+void KeccakP1600times16_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length)
+{
+    KeccakP1600times8_AddBytes((unsigned char *)states + (instanceIndex/8)*stateSetSize, instanceIndex%8, data, offset, length);
+}
+
+void KeccakP1600times16_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    KeccakP1600times8_AddLanesAll(states, data, laneCount, laneOffset);
+    KeccakP1600times8_AddLanesAll((unsigned char *)states + stateSetSize, data + 8*laneOffset*SnP_laneLengthInBytes, laneCount, laneOffset);
+}
+
+void KeccakP1600times16_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length)
+{
+    KeccakP1600times8_ExtractBytes((const unsigned char *)states + (instanceIndex/8)*stateSetSize, instanceIndex%8, data, offset, length);
+}
+
+void KeccakP1600times16_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    KeccakP1600times8_ExtractLanesAll(states, data, laneCount, laneOffset);
+    KeccakP1600times8_ExtractLanesAll((const unsigned char *)states + stateSetSize, data + 8*laneOffset*SnP_laneLengthInBytes, laneCount, laneOffset);
+}
+
+static ALIGN(KeccakP1600times16_statesAlignment) const uint64_t KeccakP1600times16_RoundConstants[24] = {
+    0x0000000000000001ULL,
+    0x0000000000008082ULL,
+    0x800000000000808aULL,
+    0x8000000080008000ULL,
+    0x000000000000808bULL,
+    0x0000000080000001ULL,
+    0x8000000080008081ULL,
+    0x8000000000008009ULL,
+    0x000000000000008aULL,
+    0x0000000000000088ULL,
+    0x0000000080008009ULL,
+    0x000000008000000aULL,
+    0x000000008000808bULL,
+    0x800000000000008bULL,
+    0x8000000000008089ULL,
+    0x8000000000008003ULL,
+    0x8000000000008002ULL,
+    0x8000000000000080ULL,
+    0x000000000000800aULL,
+    0x800000008000000aULL,
+    0x8000000080008081ULL,
+    0x8000000000008080ULL,
+    0x0000000080000001ULL,
+    0x8000000080008008ULL};
+
+#define KeccakP_DeclareVars(X) \
+    V512    X##Ba, X##Be, X##Bi, X##Bo, X##Bu; \
+    V512    X##Da, X##De, X##Di, X##Do, X##Du; \
+    V512    X##ba, X##be, X##bi, X##bo, X##bu; \
+    V512    X##ga, X##ge, X##gi, X##go, X##gu; \
+    V512    X##ka, X##ke, X##ki, X##ko, X##ku; \
+    V512    X##ma, X##me, X##mi, X##mo, X##mu; \
+    V512    X##sa, X##se, X##si, X##so, X##su
+
+#define KeccakP_Theta(X) \
+    X##Ba = XOR5( X##ba, X##ga, X##ka, X##ma, X##sa ); \
+    X##Be = XOR5( X##be, X##ge, X##ke, X##me, X##se ); \
+    X##Bi = XOR5( X##bi, X##gi, X##ki, X##mi, X##si ); \
+    X##Bo = XOR5( X##bo, X##go, X##ko, X##mo, X##so ); \
+    X##Bu = XOR5( X##bu, X##gu, X##ku, X##mu, X##su ); \
+    X##Da = XOR( ROL( X##Be, 1 ), X##Bu ); \
+    X##De = XOR( ROL( X##Bi, 1 ), X##Ba ); \
+    X##Di = XOR( ROL( X##Bo, 1 ), X##Be ); \
+    X##Do = XOR( ROL( X##Bu, 1 ), X##Bi ); \
+    X##Du = XOR( ROL( X##Ba, 1 ), X##Bo )
+
+#define KeccakP_ThetaRhoPiChi( X, _L1, _L2, _L3, _L4, _L5, _Bb1, _Bb2, _Bb3, _Bb4, _Bb5, _Rr1, _Rr2, _Rr3, _Rr4, _Rr5 ) \
+    X##_Bb1 = XOR(X##_L1, X##Da); \
+    X##_Bb2 = XOR(X##_L2, X##De); \
+    X##_Bb3 = XOR(X##_L3, X##Di); \
+    X##_Bb4 = XOR(X##_L4, X##Do); \
+    X##_Bb5 = XOR(X##_L5, X##Du); \
+    if (_Rr1 != 0) X##_Bb1 = ROL(X##_Bb1, _Rr1); \
+    X##_Bb2 = ROL(X##_Bb2, _Rr2); \
+    X##_Bb3 = ROL(X##_Bb3, _Rr3); \
+    X##_Bb4 = ROL(X##_Bb4, _Rr4); \
+    X##_Bb5 = ROL(X##_Bb5, _Rr5); \
+    X##_L1 = Chi( X##Ba, X##Be, X##Bi); \
+    X##_L2 = Chi( X##Be, X##Bi, X##Bo); \
+    X##_L3 = Chi( X##Bi, X##Bo, X##Bu); \
+    X##_L4 = Chi( X##Bo, X##Bu, X##Ba); \
+    X##_L5 = Chi( X##Bu, X##Ba, X##Be)
+
+/* One round of both sets X and Y, each step on one set followed by the same step on the other */
+#define KeccakP_RoundTimes2( rc, a1, a2, a3, a4, a5, b1, b2, b3, b4, b5, c1, c2, c3, c4, c5, d1, d2, d3, d4, d5, e1, e2, e3, e4, e5 ) \
+    KeccakP_Theta(X); \
+    KeccakP_Theta(Y); \
+    KeccakP_ThetaRhoPiChi(X, a1, a2, a3, a4, a5, Ba, Be, Bi, Bo, Bu,  0, 44, 43, 21, 14 ); \
+    X##a1 = XOR(X##a1, rc); \
+    KeccakP_ThetaRhoPiChi(Y, a1, a2, a3, a4, a5, Ba, Be, Bi, Bo, Bu,  0, 44, 43, 21, 14 ); \
+    Y##a1 = XOR(Y##a1, rc); \
+    KeccakP_ThetaRhoPiChi(X, b1, b2, b3, b4, b5, Bi, Bo, Bu, Ba, Be,  3, 45, 61, 28, 20 ); \
+    KeccakP_ThetaRhoPiChi(Y, b1, b2, b3, b4, b5, Bi, Bo, Bu, Ba, Be,  3, 45, 61, 28, 20 ); \
+    KeccakP_ThetaRhoPiChi(X, c1, c2, c3, c4, c5, Bu, Ba, Be, Bi, Bo, 18,  1,  6, 25,  8 ); \
+    KeccakP_ThetaRhoPiChi(Y, c1, c2, c3, c4, c5, Bu, Ba, Be, Bi, Bo, 18,  1,  6, 25,  8 ); \
+    KeccakP_ThetaRhoPiChi(X, d1, d2, d3, d4, d5, Be, Bi, Bo, Bu, Ba, 36, 10, 15, 56, 27 ); \
+    KeccakP_ThetaRhoPiChi(Y, d1, d2, d3, d4, d5, Be, Bi, Bo, Bu, Ba, 36, 10, 15, 56, 27 ); \
+    KeccakP_ThetaRhoPiChi(X, e1, e2, e3, e4, e5, Bo, Bu, Ba, Be, Bi, 41,  2, 62, 55, 39 ); \
+    KeccakP_ThetaRhoPiChi(Y, e1, e2, e3, e4, e5, Bo, Bu, Ba, Be, Bi, 41,  2, 62, 55, 39 )
+
+#define KeccakP_4roundsTimes2( i ) \
+    KeccakP_RoundTimes2( CONST8_64(KeccakP1600times16_RoundConstants[i]), \
+        ba, ge, ki, mo, su, ka, me, si, bo, gu, sa, be, gi, ko, mu, ga, ke, mi, so, bu, ma, se, bi, go, ku ); \
+    KeccakP_RoundTimes2( CONST8_64(KeccakP1600times16_RoundConstants[i+1]), \
+        ba, me, gi, so, ku, sa, ke, bi, mo, gu, ma, ge, si, ko, bu, ka, be, mi, go, su, ga, se, ki, bo, mu ); \
+    KeccakP_RoundTimes2( CONST8_64(KeccakP1600times16_RoundConstants[i+2]), \
+        ba, ke, si, go, mu, ma, be, ki, so, gu, ga, me, bi, ko, su, sa, ge, mi, bo, ku, ka, se, gi, mo, bu ); \
+    KeccakP_RoundTimes2( CONST8_64(KeccakP1600times16_RoundConstants[i+3]), \
+        ba, be, bi, bo, bu, ga, ge, gi, go, gu, ka, ke, ki, ko, ku, ma, me, mi, mo, mu, sa, se, si, so, su )
+
+#define rounds12 \
+    KeccakP_4roundsTimes2( 12 ); \
+    KeccakP_4roundsTimes2( 16 ); \
+    KeccakP_4roundsTimes2( 20 )
+
+#define copyFromState(X, pState) \
+    X##ba = pState[ 0]; \
+    X##be = pState[ 1]; \
+    X##bi = pState[ 2]; \
+    X##bo = pState[ 3]; \
+    X##bu = pState[ 4]; \
+    X##ga = pState[ 5]; \
+    X##ge = pState[ 6]; \
+    X##gi = pState[ 7]; \
+    X##go = pState[ 8]; \
+    X##gu = pState[ 9]; \
+    X##ka = pState[10]; \
+    X##ke = pState[11]; \
+    X##ki = pState[12]; \
+    X##ko = pState[13]; \
+    X##ku = pState[14]; \
+    X##ma = pState[15]; \
+    X##me = pState[16]; \
+    X##mi = pState[17]; \
+    X##mo = pState[18]; \
+    X##mu = pState[19]; \
+    X##sa = pState[20]; \
+    X##se = pState[21]; \
+    X##si = pState[22]; \
+    X##so = pState[23]; \
+    X##su = pState[24];
+
+#define copyToState(pState, X) \
+    pState[ 0] = X##ba; \
+    pState[ 1] = X##be; \
+    pState[ 2] = X##bi; \
+    pState[ 3] = X##bo; \
+    pState[ 4] = X##bu; \
+    pState[ 5] = X##ga; \
+    pState[ 6] = X##ge; \
+    pState[ 7] = X##gi; \
+    pState[ 8] = X##go; \
+    pState[ 9] = X##gu; \
+    pState[10] = X##ka; \
+    pState[11] = X##ke; \
+    pState[12] = X##ki; \
+    pState[13] = X##ko; \
+    pState[14] = X##ku; \
+    pState[15] = X##ma; \
+    pState[16] = X##me; \
+    pState[17] = X##mi; \
+    pState[18] = X##mo; \
+    pState[19] = X##mu; \
+    pState[20] = X##sa; \
+    pState[21] = X##se; \
+    pState[22] = X##si; \
+    pState[23] = X##so; \
+    pState[24] = X##su;
+
+void KeccakP1600times16_PermuteAll_12rounds(void *states)
+{
+    V512 *statesAsLanes = states;
+    KeccakP_DeclareVars(X);
+    KeccakP_DeclareVars(Y);
+
+    copyFromState(X, statesAsLanes);
+    copyFromState(Y, (statesAsLanes+25));
+    rounds12;
+    copyToState(statesAsLanes, X);
+    copyToState((statesAsLanes+25), Y);
+}
+
+size_t KeccakP1600times16_12rounds_FastLoop_Absorb(void *states, unsigned int laneCount, unsigned int laneOffsetParallel, unsigned int laneOffsetSerial, const unsigned char *data, size_t dataByteLen)
+{
+    size_t dataMinimumSize = (laneOffsetParallel*15 + laneCount)*8;
+
+    if (laneCount == 21) {
+        const unsigned char *dataStart = data;
+        V512 *statesAsLanes = states;
+        const uint64_t *dataAsLanes = (const uint64_t *)data;
+        KeccakP_DeclareVars(X);
+        KeccakP_DeclareVars(Y);
+
+        copyFromState(X, statesAsLanes);
+        copyFromState(Y, (statesAsLanes+25));
+        while(dataByteLen >= dataMinimumSize) {
+            ADD_TRANSPOSED21_64(X, dataAsLanes, laneOffsetParallel)
+            ADD_TRANSPOSED21_64(Y, dataAsLanes + 8*laneOffsetParallel, laneOffsetParallel)
+            rounds12;
+            dataAsLanes += laneOffsetSerial;
+            dataByteLen -= laneOffsetSerial*8;
+        }
+        copyToState(statesAsLanes, X);
+        copyToState((statesAsLanes+25), Y);
+        return (const unsigned char *)dataAsLanes - dataStart;
+    }
+    else {
+        const unsigned char *dataStart = data;
+
+        while(dataByteLen >= dataMinimumSize) {
+            KeccakP1600times16_AddLanesAll(states, data, laneCount, laneOffsetParallel);
+            KeccakP1600times16_PermuteAll_12rounds(states);
+            data += laneOffsetSerial*8;
+            dataByteLen -= laneOffsetSerial*8;
+        }
+        return data - dataStart;
+    }
+}
+
+#endif
@@ -44,7 +44,7 @@ Please refer to the XKCP for more details.
 
 typedef uint8_t     UINT8;
 typedef uint32_t    UINT32;
-typedef uint64_t    UINT64;
+typedef unsigned long long int UINT64;
 
 typedef __m128i     V128;
 typedef __m256i     V256;
@@ -210,7 +210,7 @@ void KeccakP1600times2_ExtractLanesAll(const void *states, unsigned char *data,
     #undef  Extr4
 }
 
-static ALIGN(KeccakP1600times2_statesAlignment) const UINT64 KeccakP1600RoundConstants[24] = {
+static ALIGN(KeccakP1600times2_statesAlignment) const UINT64 KeccakP1600times2_RoundConstants[24] = {
     0x0000000000000001ULL,
     0x0000000000008082ULL,
     0x800000000000808aULL,
@@ -294,25 +294,25 @@ static ALIGN(KeccakP1600times2_statesAlignment) const UINT64 KeccakP1600RoundCon
     KeccakP_ThetaRhoPiChi( _L1, _L2, _L3, _L4, _L5, _Bo, _Bu, _Ba, _Be, _Bi, 41,  2, 62, 55, 39 )
 
 #define KeccakP_4rounds( i ) \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _ge, _ki, _mo, _su, CONST128_64(KeccakP1600RoundConstants[i]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _ge, _ki, _mo, _su, CONST128_64(KeccakP1600times2_RoundConstants[i]) ); \
     KeccakP_ThetaRhoPiChi1(    _ka, _me, _si, _bo, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _sa, _be, _gi, _ko, _mu ); \
     KeccakP_ThetaRhoPiChi3(    _ga, _ke, _mi, _so, _bu ); \
     KeccakP_ThetaRhoPiChi4(    _ma, _se, _bi, _go, _ku ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _me, _gi, _so, _ku, CONST128_64(KeccakP1600RoundConstants[i+1]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _me, _gi, _so, _ku, CONST128_64(KeccakP1600times2_RoundConstants[i+1]) ); \
     KeccakP_ThetaRhoPiChi1(    _sa, _ke, _bi, _mo, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ma, _ge, _si, _ko, _bu ); \
     KeccakP_ThetaRhoPiChi3(    _ka, _be, _mi, _go, _su ); \
     KeccakP_ThetaRhoPiChi4(    _ga, _se, _ki, _bo, _mu ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _ke, _si, _go, _mu, CONST128_64(KeccakP1600RoundConstants[i+2]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _ke, _si, _go, _mu, CONST128_64(KeccakP1600times2_RoundConstants[i+2]) ); \
     KeccakP_ThetaRhoPiChi1(    _ma, _be, _ki, _so, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ga, _me, _bi, _ko, _su ); \
     KeccakP_ThetaRhoPiChi3(    _sa, _ge, _mi, _bo, _ku ); \
     KeccakP_ThetaRhoPiChi4(    _ka, _se, _gi, _mo, _bu ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _be, _bi, _bo, _bu, CONST128_64(KeccakP1600RoundConstants[i+3]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _be, _bi, _bo, _bu, CONST128_64(KeccakP1600times2_RoundConstants[i+3]) ); \
     KeccakP_ThetaRhoPiChi1(    _ga, _ge, _gi, _go, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ka, _ke, _ki, _ko, _ku ); \
     KeccakP_ThetaRhoPiChi3(    _ma, _me, _mi, _mo, _mu ); \
@@ -469,3 +469,13 @@ size_t KeccakP1600times2_12rounds_FastLoop_Absorb(void *states, unsigned int lan
         return data - dataStart;
     }
 }
+
+/* The other SIMD512 sources redefine these when they follow in one translation unit (libk12-amalgamated.a) */
+#undef XOR
+#undef XOR3
+#undef ROL
+#undef Chi
+#undef LOAD8_32
+#undef laneIndex
+#undef KeccakP_DeclareVars
+#undef KeccakP_4rounds
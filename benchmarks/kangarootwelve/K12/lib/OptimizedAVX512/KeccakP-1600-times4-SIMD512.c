@@ -44,7 +44,7 @@ Please refer to the XKCP for more details.
 
 typedef uint8_t     UINT8;
 typedef uint32_t    UINT32;
-typedef uint64_t    UINT64;
+typedef unsigned long long int UINT64;   /* As in the AVX2 sources, for SkylakeX-ymm/libk12-amalgamated.a */
 
 typedef __m128i     V128;
 typedef __m256i     V256;
@@ -69,6 +69,22 @@ typedef __m512i     V512;
 
 #endif
 
+#if defined(KeccakP1600times4_prefetchDistance)
+/* Requests the next blocks of the 4 leaves, KeccakP1600times4_prefetchDistance bytes ahead of the absorbing */
+#define PREFETCH4_64(p, stride) \
+    { \
+        unsigned int k; \
+        for(k=0; k<4; k++) { \
+            const char *q = (const char *)((p) + k*(stride)) + KeccakP1600times4_prefetchDistance; \
+            _mm_prefetch(q, _MM_HINT_T0); \
+            _mm_prefetch(q + 64, _MM_HINT_T0); \
+            _mm_prefetch(q + 128, _MM_HINT_T0); \
+        } \
+    }
+#else
+#define PREFETCH4_64(p, stride)
+#endif
+
 #define laneIndex(instanceIndex, lanePosition)  ((lanePosition)*4 + instanceIndex)
 #define SnP_laneLengthInBytes                   8
 
@@ -115,16 +131,24 @@ void KeccakP1600times4_AddBytes(void *states, unsigned int instanceIndex, const
 void KeccakP1600times4_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
 {
     V256 *stateAsLanes256 = states;
-    V512 *stateAsLanes512 = states;
     const UINT64 *dataAsLanes = (const UINT64 *)data;
     unsigned int i;
-    V256 index512;
     V128 index256;
+    #if !defined(KeccakP1600times4_use256bitRegistersOnly)
+    V512 *stateAsLanes512 = states;
+    V256 index512;
+    #endif
 
     #define Add_In1( argIndex )  stateAsLanes256[argIndex] = XOR(stateAsLanes256[argIndex], LOAD_GATHER4_64(index256, dataAsLanes+argIndex))
+    #if defined(KeccakP1600times4_use256bitRegistersOnly)
+    #define Add_In2( argIndex )  Add_In1( argIndex ), Add_In1( argIndex+1 )
+    #else
     #define Add_In2( argIndex )  stateAsLanes512[argIndex/2] = XOR512(stateAsLanes512[argIndex/2], LOAD_GATHER8_64(index512, dataAsLanes+argIndex))
+    #endif
     index256 = LOAD4_32(3*laneOffset, 2*laneOffset, 1*laneOffset, 0*laneOffset);
+    #if !defined(KeccakP1600times4_use256bitRegistersOnly)
     index512 = LOAD8_32(3*laneOffset+1, 2*laneOffset+1, 1*laneOffset+1, 0*laneOffset+1, 3*laneOffset, 2*laneOffset, 1*laneOffset, 0*laneOffset);
+    #endif
     if ( laneCount >= 16 )  {
         Add_In2( 0 );
         Add_In2( 2 );
@@ -186,16 +210,24 @@ void KeccakP1600times4_ExtractBytes(const void *states, unsigned int instanceInd
 void KeccakP1600times4_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
 {
     const V256 *stateAsLanes256 = states;
-    const V512 *stateAsLanes512 = states;
     UINT64 *dataAsLanes = (UINT64 *)data;
     unsigned int i;
-    V256 index512;
     V128 index256;
+    #if !defined(KeccakP1600times4_use256bitRegistersOnly)
+    const V512 *stateAsLanes512 = states;
+    V256 index512;
+    #endif
 
     #define Extr1( argIndex )  STORE_SCATTER4_64(dataAsLanes+argIndex, index256, stateAsLanes256[argIndex])
+    #if defined(KeccakP1600times4_use256bitRegistersOnly)
+    #define Extr2( argIndex )  Extr1( argIndex ), Extr1( argIndex+1 )
+    #else
     #define Extr2( argIndex )  STORE_SCATTER8_64(dataAsLanes+argIndex, index512, stateAsLanes512[argIndex/2])
+    #endif
     index256 = LOAD4_32(3*laneOffset, 2*laneOffset, 1*laneOffset, 0*laneOffset);
+    #if !defined(KeccakP1600times4_use256bitRegistersOnly)
     index512 = LOAD8_32(3*laneOffset+1, 2*laneOffset+1, 1*laneOffset+1, 0*laneOffset+1, 3*laneOffset, 2*laneOffset, 1*laneOffset, 0*laneOffset);
+    #endif
     if ( laneCount >= 16 )  {
         Extr2( 0 );
         Extr2( 2 );
@@ -224,7 +256,7 @@ void KeccakP1600times4_ExtractLanesAll(const void *states, unsigned char *data,
     #undef  Extr2
 }
 
-static ALIGN(KeccakP1600times4_statesAlignment) const UINT64 KeccakP1600RoundConstants[24] = {
+static ALIGN(KeccakP1600times4_statesAlignment) const UINT64 KeccakP1600times4_RoundConstants[24] = {
     0x0000000000000001ULL,
     0x0000000000008082ULL,
     0x800000000000808aULL,
@@ -308,25 +340,25 @@ static ALIGN(KeccakP1600times4_statesAlignment) const UINT64 KeccakP1600RoundCon
     KeccakP_ThetaRhoPiChi( _L1, _L2, _L3, _L4, _L5, _Bo, _Bu, _Ba, _Be, _Bi, 41,  2, 62, 55, 39 )
 
 #define KeccakP_4rounds( i ) \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _ge, _ki, _mo, _su, CONST256_64(KeccakP1600RoundConstants[i]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _ge, _ki, _mo, _su, CONST256_64(KeccakP1600times4_RoundConstants[i]) ); \
     KeccakP_ThetaRhoPiChi1(    _ka, _me, _si, _bo, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _sa, _be, _gi, _ko, _mu ); \
     KeccakP_ThetaRhoPiChi3(    _ga, _ke, _mi, _so, _bu ); \
     KeccakP_ThetaRhoPiChi4(    _ma, _se, _bi, _go, _ku ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _me, _gi, _so, _ku, CONST256_64(KeccakP1600RoundConstants[i+1]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _me, _gi, _so, _ku, CONST256_64(KeccakP1600times4_RoundConstants[i+1]) ); \
     KeccakP_ThetaRhoPiChi1(    _sa, _ke, _bi, _mo, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ma, _ge, _si, _ko, _bu ); \
     KeccakP_ThetaRhoPiChi3(    _ka, _be, _mi, _go, _su ); \
     KeccakP_ThetaRhoPiChi4(    _ga, _se, _ki, _bo, _mu ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _ke, _si, _go, _mu, CONST256_64(KeccakP1600RoundConstants[i+2]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _ke, _si, _go, _mu, CONST256_64(KeccakP1600times4_RoundConstants[i+2]) ); \
     KeccakP_ThetaRhoPiChi1(    _ma, _be, _ki, _so, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ga, _me, _bi, _ko, _su ); \
     KeccakP_ThetaRhoPiChi3(    _sa, _ge, _mi, _bo, _ku ); \
     KeccakP_ThetaRhoPiChi4(    _ka, _se, _gi, _mo, _bu ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _be, _bi, _bo, _bu, CONST256_64(KeccakP1600RoundConstants[i+3]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _be, _bi, _bo, _bu, CONST256_64(KeccakP1600times4_RoundConstants[i+3]) ); \
     KeccakP_ThetaRhoPiChi1(    _ga, _ge, _gi, _go, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ka, _ke, _ki, _ko, _ku ); \
     KeccakP_ThetaRhoPiChi3(    _ma, _me, _mi, _mo, _mu ); \
@@ -442,6 +474,7 @@ size_t KeccakP1600times4_12rounds_FastLoop_Absorb(void *states, unsigned int lan
         copyFromState(statesAsLanes);
         index = LOAD4_32(3*laneOffsetParallel, 2*laneOffsetParallel, 1*laneOffsetParallel, 0*laneOffsetParallel);
         while(dataByteLen >= dataMinimumSize) {
+            PREFETCH4_64(dataAsLanes, laneOffsetParallel)
             #define Add_In( argLane, argIndex )  argLane = XOR(argLane, LOAD_GATHER4_64(index, dataAsLanes+argIndex))
             Add_In( _ba, 0 );
             Add_In( _be, 1 );
@@ -484,3 +517,125 @@ size_t KeccakP1600times4_12rounds_FastLoop_Absorb(void *states, unsigned int lan
         return data - dataStart;
     }
 }
+
+/* KangarooTwelve leaves: 8192 bytes = 48 blocks of 21 lanes + 16 lanes, suffix 0x0B, 32-byte chaining values */
+#define LeafCVs_chunkLanes      (8192/8)
+#define LeafCVs_fullBlocks      (8192/168)
+
+void KeccakP1600times4_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues)
+{
+    #if !defined(KeccakP1600times4_fullUnrolling) && (KeccakP1600times4_unrolling < 12)
+    unsigned int i;
+    #endif
+    const uint64_t *dataAsLanes = (const uint64_t *)data;
+    uint64_t *cvsAsLanes = (uint64_t *)chainingValues;
+    const uint64_t suffix = 0x0B;
+    const uint64_t padding = 0x8000000000000000ULL;
+    unsigned int j;
+    KeccakP_DeclareVars;
+    V128 index;
+
+    index = LOAD4_32(3*LeafCVs_chunkLanes, 2*LeafCVs_chunkLanes, 1*LeafCVs_chunkLanes, 0*LeafCVs_chunkLanes);
+    #define Load_In( argLane, argIndex )  argLane = LOAD_GATHER4_64(index, dataAsLanes+argIndex)
+    #define Add_In( argLane, argIndex )  argLane = XOR(argLane, LOAD_GATHER4_64(index, dataAsLanes+argIndex))
+
+    /* First block: the state is still all zero */
+    PREFETCH4_64(dataAsLanes, LeafCVs_chunkLanes)
+    Load_In( _ba, 0 );
+    Load_In( _be, 1 );
+    Load_In( _bi, 2 );
+    Load_In( _bo, 3 );
+    Load_In( _bu, 4 );
+    Load_In( _ga, 5 );
+    Load_In( _ge, 6 );
+    Load_In( _gi, 7 );
+    Load_In( _go, 8 );
+    Load_In( _gu, 9 );
+    Load_In( _ka, 10 );
+    Load_In( _ke, 11 );
+    Load_In( _ki, 12 );
+    Load_In( _ko, 13 );
+    Load_In( _ku, 14 );
+    Load_In( _ma, 15 );
+    Load_In( _me, 16 );
+    Load_In( _mi, 17 );
+    Load_In( _mo, 18 );
+    Load_In( _mu, 19 );
+    Load_In( _sa, 20 );
+    _se = _mm256_setzero_si256();
+    _si = _mm256_setzero_si256();
+    _so = _mm256_setzero_si256();
+    _su = _mm256_setzero_si256();
+    rounds12;
+    dataAsLanes += 21;
+
+    for(j=1; j<LeafCVs_fullBlocks; j++) {
+        PREFETCH4_64(dataAsLanes, LeafCVs_chunkLanes)
+        Add_In( _ba, 0 );
+        Add_In( _be, 1 );
+        Add_In( _bi, 2 );
+        Add_In( _bo, 3 );
+        Add_In( _bu, 4 );
+        Add_In( _ga, 5 );
+        Add_In( _ge, 6 );
+        Add_In( _gi, 7 );
+        Add_In( _go, 8 );
+        Add_In( _gu, 9 );
+        Add_In( _ka, 10 );
+        Add_In( _ke, 11 );
+        Add_In( _ki, 12 );
+        Add_In( _ko, 13 );
+        Add_In( _ku, 14 );
+        Add_In( _ma, 15 );
+        Add_In( _me, 16 );
+        Add_In( _mi, 17 );
+        Add_In( _mo, 18 );
+        Add_In( _mu, 19 );
+        Add_In( _sa, 20 );
+        rounds12;
+        dataAsLanes += 21;
+    }
+
+    /* Last block: 16 lanes of data, then the suffix and the padding */
+    Add_In( _ba, 0 );
+    Add_In( _be, 1 );
+    Add_In( _bi, 2 );
+    Add_In( _bo, 3 );
+    Add_In( _bu, 4 );
+    Add_In( _ga, 5 );
+    Add_In( _ge, 6 );
+    Add_In( _gi, 7 );
+    Add_In( _go, 8 );
+    Add_In( _gu, 9 );
+    Add_In( _ka, 10 );
+    Add_In( _ke, 11 );
+    Add_In( _ki, 12 );
+    Add_In( _ko, 13 );
+    Add_In( _ku, 14 );
+    Add_In( _ma, 15 );
+    _me = XOR(_me, CONST256_64(suffix));
+    _sa = XOR(_sa, CONST256_64(padding));
+    #undef  Load_In
+    #undef  Add_In
+    rounds12;
+
+    /* The chaining values are the first 4 lanes of each instance */
+    index = LOAD4_32(3*4, 2*4, 1*4, 0*4);
+    STORE_SCATTER4_64(cvsAsLanes+0, index, _ba);
+    STORE_SCATTER4_64(cvsAsLanes+1, index, _be);
+    STORE_SCATTER4_64(cvsAsLanes+2, index, _bi);
+    STORE_SCATTER4_64(cvsAsLanes+3, index, _bo);
+}
+
+/* For the single-translation-unit builds, where the AVX2 sources may also follow */
+#undef XOR
+#undef XOR3
+#undef ROL
+#undef Chi
+#undef LOAD8_32
+#undef laneIndex
+#undef KeccakP_DeclareVars
+#undef KeccakP_4rounds
+#undef rounds12
+#undef copyFromState
+#undef copyToState
@@ -66,9 +66,141 @@ typedef __m512i     V512;
 #define LOAD_GATHER8_64(idx,p)      _mm512_i32gather_epi64( idx, (const void*)(p), 8)
 
 #define STORE_SCATTER8_64(p,idx, v) _mm512_i32scatter_epi64( (void*)(p), idx, v, 8)
+#define LOAD_MASK_GATHER8_64(m,idx,p)       _mm512_mask_i32gather_epi64( _mm512_setzero_si512(), m, idx, (const void*)(p), 8)
+#define STORE_MASK_SCATTER8_64(p,m,idx, v)  _mm512_mask_i32scatter_epi64( (void*)(p), m, idx, v, 8)
+#define LOAD_MASK8_64(m,p)          _mm512_maskz_loadu_epi64( m, (const void*)(p))
 
 #endif
 
+#if defined(KeccakP1600times8_useTransposedLoads) || defined(KeccakP1600times8_useTransposedStores)
+/* Transposes the 8x8 matrix of lanes r0 to r7 with unpacks and 128-bit shuffles */
+#define TRANSPOSE8x8_64(r0, r1, r2, r3, r4, r5, r6, r7) \
+    { \
+        V512 t0, t1, t2, t3, t4, t5, t6, t7; \
+        t0 = _mm512_unpacklo_epi64(r0, r1); \
+        t1 = _mm512_unpackhi_epi64(r0, r1); \
+        t2 = _mm512_unpacklo_epi64(r2, r3); \
+        t3 = _mm512_unpackhi_epi64(r2, r3); \
+        t4 = _mm512_unpacklo_epi64(r4, r5); \
+        t5 = _mm512_unpackhi_epi64(r4, r5); \
+        t6 = _mm512_unpacklo_epi64(r6, r7); \
+        t7 = _mm512_unpackhi_epi64(r6, r7); \
+        r0 = _mm512_shuffle_i64x2(t0, t2, 0x88); \
+        r1 = _mm512_shuffle_i64x2(t0, t2, 0xDD); \
+        r2 = _mm512_shuffle_i64x2(t4, t6, 0x88); \
+        r3 = _mm512_shuffle_i64x2(t4, t6, 0xDD); \
+        r4 = _mm512_shuffle_i64x2(t1, t3, 0x88); \
+        r5 = _mm512_shuffle_i64x2(t1, t3, 0xDD); \
+        r6 = _mm512_shuffle_i64x2(t5, t7, 0x88); \
+        r7 = _mm512_shuffle_i64x2(t5, t7, 0xDD); \
+        t0 = _mm512_shuffle_i64x2(r0, r2, 0x88); \
+        t4 = _mm512_shuffle_i64x2(r0, r2, 0xDD); \
+        t2 = _mm512_shuffle_i64x2(r1, r3, 0x88); \
+        t6 = _mm512_shuffle_i64x2(r1, r3, 0xDD); \
+        t1 = _mm512_shuffle_i64x2(r4, r6, 0x88); \
+        t5 = _mm512_shuffle_i64x2(r4, r6, 0xDD); \
+        t3 = _mm512_shuffle_i64x2(r5, r7, 0x88); \
+        t7 = _mm512_shuffle_i64x2(r5, r7, 0xDD); \
+        r0 = t0; r1 = t1; r2 = t2; r3 = t3; r4 = t4; r5 = t5; r6 = t6; r7 = t7; \
+    }
+#endif
+
+#if defined(KeccakP1600times8_useTransposedLoads)
+/*
+Instead of one gather per lane, the rows of 8 consecutive lanes of the 8 instances are loaded
+and transposed, so that each vector holds one lane of the 8 instances.
+The lanes of instance k outside rowMask(k) read as zero.
+*/
+
+/* XORs lanes p[0..7] of the 8 instances, stride lanes apart, into L0 to L7 */
+#define ADD_TRANSPOSED8_64(L0, L1, L2, L3, L4, L5, L6, L7, p, stride, rowMask) \
+    { \
+        V512 r0, r1, r2, r3, r4, r5, r6, r7; \
+        r0 = LOAD_MASK8_64(rowMask(0), (p)+0*(stride)); \
+        r1 = LOAD_MASK8_64(rowMask(1), (p)+1*(stride)); \
+        r2 = LOAD_MASK8_64(rowMask(2), (p)+2*(stride)); \
+        r3 = LOAD_MASK8_64(rowMask(3), (p)+3*(stride)); \
+        r4 = LOAD_MASK8_64(rowMask(4), (p)+4*(stride)); \
+        r5 = LOAD_MASK8_64(rowMask(5), (p)+5*(stride)); \
+        r6 = LOAD_MASK8_64(rowMask(6), (p)+6*(stride)); \
+        r7 = LOAD_MASK8_64(rowMask(7), (p)+7*(stride)); \
+        TRANSPOSE8x8_64(r0, r1, r2, r3, r4, r5, r6, r7) \
+        L0 = XOR(L0, r0); \
+        L1 = XOR(L1, r1); \
+        L2 = XOR(L2, r2); \
+        L3 = XOR(L3, r3); \
+        L4 = XOR(L4, r4); \
+        L5 = XOR(L5, r5); \
+        L6 = XOR(L6, r6); \
+        L7 = XOR(L7, r7); \
+    }
+
+/* Same for the 5 lanes p[0..4], as in the last lanes of a block of 21 lanes */
+#define ADD_TRANSPOSED5_64(L0, L1, L2, L3, L4, p, stride, rowMask) \
+    { \
+        V512 unused5 = _mm512_setzero_si512(), unused6 = unused5, unused7 = unused5; \
+        ADD_TRANSPOSED8_64(L0, L1, L2, L3, L4, unused5, unused6, unused7, p, stride, rowMask) \
+    }
+
+/* Blocks of 21 lanes, in 8 + 8 + 5 lanes */
+#define ADD_TRANSPOSED21_64(p, stride, rowMask, tailRowMask) \
+    ADD_TRANSPOSED8_64(_ba, _be, _bi, _bo, _bu, _ga, _ge, _gi, (p)+0, stride, rowMask) \
+    ADD_TRANSPOSED8_64(_go, _gu, _ka, _ke, _ki, _ko, _ku, _ma, (p)+8, stride, rowMask) \
+    ADD_TRANSPOSED5_64(_me, _mi, _mo, _mu, _sa, (p)+16, stride, tailRowMask)
+
+#define allLanes(k)         0xFF
+#define firstFiveLanes(k)   0x1F
+#endif
+
+#if defined(KeccakP1600times8_useTransposedStores)
+/*
+Instead of one scatter per lane, the lanes are transposed back into rows, one per instance,
+which are written with ordinary (masked) stores.
+*/
+#define STORE_MASK8_64(p,m,v)       _mm512_mask_storeu_epi64( (void*)(p), m, v)
+
+/* Writes the first 4 lanes L0 to L3 of the instances in mask as 8 consecutive 32-byte rows at p */
+#define STORE_TRANSPOSED4x8_64(p, mask, L0, L1, L2, L3) \
+    { \
+        V512 t0, t1, t2, t3, u0, u1, u2, u3; \
+        t0 = _mm512_unpacklo_epi64(L0, L1); \
+        t1 = _mm512_unpackhi_epi64(L0, L1); \
+        t2 = _mm512_unpacklo_epi64(L2, L3); \
+        t3 = _mm512_unpackhi_epi64(L2, L3); \
+        u0 = _mm512_shuffle_i64x2(t0, t2, 0x44); \
+        u1 = _mm512_shuffle_i64x2(t1, t3, 0x44); \
+        u2 = _mm512_shuffle_i64x2(t0, t2, 0xEE); \
+        u3 = _mm512_shuffle_i64x2(t1, t3, 0xEE); \
+        STORE_MASK8_64((p)+ 0, rowPairMask(mask, 0), _mm512_shuffle_i64x2(u0, u1, 0x88)); \
+        STORE_MASK8_64((p)+ 8, rowPairMask(mask, 2), _mm512_shuffle_i64x2(u0, u1, 0xDD)); \
+        STORE_MASK8_64((p)+16, rowPairMask(mask, 4), _mm512_shuffle_i64x2(u2, u3, 0x88)); \
+        STORE_MASK8_64((p)+24, rowPairMask(mask, 6), _mm512_shuffle_i64x2(u2, u3, 0xDD)); \
+    }
+
+/* The lanes of the 64-byte row of instances k and k+1 that are in mask */
+#define rowPairMask(mask, k)    (__mmask8)(((((mask) >> (k)) & 1) ? 0x0F : 0x00) | ((((mask) >> ((k)+1)) & 1) ? 0xF0 : 0x00))
+#endif
+
+#if defined(KeccakP1600times8_prefetchDistance)
+/*
+The 8 input streams are too far apart for the hardware prefetchers once they come from memory,
+so the 168 bytes that each instance absorbs KeccakP1600times8_prefetchDistance bytes later are
+requested in advance. Three lines per block are enough, as a block is shorter than three lines.
+*/
+#define PREFETCH8_64(p, stride) \
+    { \
+        unsigned int k; \
+        for(k=0; k<8; k++) { \
+            const char *q = (const char *)((p) + k*(stride)) + KeccakP1600times8_prefetchDistance; \
+            _mm_prefetch(q, _MM_HINT_T0); \
+            _mm_prefetch(q + 64, _MM_HINT_T0); \
+            _mm_prefetch(q + 128, _MM_HINT_T0); \
+        } \
+    }
+#else
+#define PREFETCH8_64(p, stride)
+#endif
+
 #define laneIndex(instanceIndex, lanePosition)  ((lanePosition)*8 + instanceIndex)
 #define SnP_laneLengthInBytes                   8
 
@@ -114,6 +246,27 @@ void KeccakP1600times8_AddBytes(void *states, unsigned int instanceIndex, const
 
 void KeccakP1600times8_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
 {
+    #if defined(KeccakP1600times8_useTransposedLoads)
+    V512 *stateAsLanes = states;
+    const uint64_t *dataAsLanes = (const uint64_t *)data;
+    unsigned int i;
+    __mmask8 tailMask = (__mmask8)((1 << (laneCount%8)) - 1);
+
+    #define tailLanes(k)    tailMask
+    for(i=0; i+8<=laneCount; i+=8)
+        ADD_TRANSPOSED8_64(stateAsLanes[i], stateAsLanes[i+1], stateAsLanes[i+2], stateAsLanes[i+3],
+            stateAsLanes[i+4], stateAsLanes[i+5], stateAsLanes[i+6], stateAsLanes[i+7], dataAsLanes+i, laneOffset, allLanes)
+    if (tailMask != 0) {
+        V512 lanes[8];
+        unsigned int j;
+        for(j=0; j<8; j++)
+            lanes[j] = _mm512_setzero_si512();
+        ADD_TRANSPOSED8_64(lanes[0], lanes[1], lanes[2], lanes[3], lanes[4], lanes[5], lanes[6], lanes[7], dataAsLanes+i, laneOffset, tailLanes)
+        for(j=0; i+j<laneCount; j++)
+            stateAsLanes[i+j] = XOR(stateAsLanes[i+j], lanes[j]);
+    }
+    #undef tailLanes
+    #else
     V512 *stateAsLanes = states;
     const uint64_t *dataAsLanes = (const uint64_t *)data;
     unsigned int i;
@@ -156,6 +309,7 @@ void KeccakP1600times8_AddLanesAll(void *states, const unsigned char *data, unsi
             Add_In( i );
     }
     #undef  Add_In
+    #endif
 }
 
 void KeccakP1600times8_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length)
@@ -190,6 +344,29 @@ void KeccakP1600times8_ExtractBytes(const void *states, unsigned int instanceInd
 
 void KeccakP1600times8_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
 {
+    #if defined(KeccakP1600times8_useTransposedStores)
+    const V512 *stateAsLanes = states;
+    uint64_t *dataAsLanes = (uint64_t *)data;
+    unsigned int i, j;
+
+    if ((laneCount == 4) && (laneOffset == 4)) {
+        /* Consecutive chaining values */
+        STORE_TRANSPOSED4x8_64(dataAsLanes, 0xFF, stateAsLanes[0], stateAsLanes[1], stateAsLanes[2], stateAsLanes[3])
+        return;
+    }
+    /* Each group of 8 lanes (or fewer at the end) is transposed into 8 rows of the instances */
+    for(i=0; i<laneCount; i+=8) {
+        unsigned int groupCount = (laneCount - i < 8) ? (laneCount - i) : 8;
+        __mmask8 groupMask = (__mmask8)((1 << groupCount) - 1);
+        V512 r[8];
+
+        for(j=0; j<8; j++)
+            r[j] = (j < groupCount) ? stateAsLanes[i+j] : _mm512_setzero_si512();
+        TRANSPOSE8x8_64(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7])
+        for(j=0; j<8; j++)
+            STORE_MASK8_64(dataAsLanes + j*laneOffset + i, groupMask, r[j]);
+    }
+    #else
     const V512 *stateAsLanes = states;
     uint64_t *dataAsLanes = (uint64_t *)data;
     unsigned int i;
@@ -232,9 +409,10 @@ void KeccakP1600times8_ExtractLanesAll(const void *states, unsigned char *data,
             Extr( i );
     }
     #undef  Extr
+    #endif
 }
 
-static ALIGN(KeccakP1600times8_statesAlignment) const uint64_t KeccakP1600RoundConstants[24] = {
+static ALIGN(KeccakP1600times8_statesAlignment) const uint64_t KeccakP1600times8_RoundConstants[24] = {
     0x0000000000000001ULL,
     0x0000000000008082ULL,
     0x800000000000808aULL,
@@ -318,25 +496,25 @@ static ALIGN(KeccakP1600times8_statesAlignment) const uint64_t KeccakP1600RoundC
     KeccakP_ThetaRhoPiChi( _L1, _L2, _L3, _L4, _L5, _Bo, _Bu, _Ba, _Be, _Bi, 41,  2, 62, 55, 39 )
 
 #define KeccakP_4rounds( i ) \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _ge, _ki, _mo, _su, CONST8_64(KeccakP1600RoundConstants[i]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _ge, _ki, _mo, _su, CONST8_64(KeccakP1600times8_RoundConstants[i]) ); \
     KeccakP_ThetaRhoPiChi1(    _ka, _me, _si, _bo, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _sa, _be, _gi, _ko, _mu ); \
     KeccakP_ThetaRhoPiChi3(    _ga, _ke, _mi, _so, _bu ); \
     KeccakP_ThetaRhoPiChi4(    _ma, _se, _bi, _go, _ku ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _me, _gi, _so, _ku, CONST8_64(KeccakP1600RoundConstants[i+1]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _me, _gi, _so, _ku, CONST8_64(KeccakP1600times8_RoundConstants[i+1]) ); \
     KeccakP_ThetaRhoPiChi1(    _sa, _ke, _bi, _mo, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ma, _ge, _si, _ko, _bu ); \
     KeccakP_ThetaRhoPiChi3(    _ka, _be, _mi, _go, _su ); \
     KeccakP_ThetaRhoPiChi4(    _ga, _se, _ki, _bo, _mu ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _ke, _si, _go, _mu, CONST8_64(KeccakP1600RoundConstants[i+2]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _ke, _si, _go, _mu, CONST8_64(KeccakP1600times8_RoundConstants[i+2]) ); \
     KeccakP_ThetaRhoPiChi1(    _ma, _be, _ki, _so, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ga, _me, _bi, _ko, _su ); \
     KeccakP_ThetaRhoPiChi3(    _sa, _ge, _mi, _bo, _ku ); \
     KeccakP_ThetaRhoPiChi4(    _ka, _se, _gi, _mo, _bu ); \
 \
-    KeccakP_ThetaRhoPiChiIota0(_ba, _be, _bi, _bo, _bu, CONST8_64(KeccakP1600RoundConstants[i+3]) ); \
+    KeccakP_ThetaRhoPiChiIota0(_ba, _be, _bi, _bo, _bu, CONST8_64(KeccakP1600times8_RoundConstants[i+3]) ); \
     KeccakP_ThetaRhoPiChi1(    _ga, _ge, _gi, _go, _gu ); \
     KeccakP_ThetaRhoPiChi2(    _ka, _ke, _ki, _ko, _ku ); \
     KeccakP_ThetaRhoPiChi3(    _ma, _me, _mi, _mo, _mu ); \
@@ -447,11 +625,19 @@ size_t KeccakP1600times8_12rounds_FastLoop_Absorb(void *states, unsigned int lan
         V512 *statesAsLanes = states;
         const uint64_t *dataAsLanes = (const uint64_t *)data;
         KeccakP_DeclareVars;
+        #if !defined(KeccakP1600times8_useTransposedLoads)
         V256 index;
+        #endif
 
         copyFromState(statesAsLanes);
+        #if !defined(KeccakP1600times8_useTransposedLoads)
         index = LOAD8_32(7*laneOffsetParallel, 6*laneOffsetParallel, 5*laneOffsetParallel, 4*laneOffsetParallel, 3*laneOffsetParallel, 2*laneOffsetParallel, 1*laneOffsetParallel, 0*laneOffsetParallel);
+        #endif
         while(dataByteLen >= dataMinimumSize) {
+            PREFETCH8_64(dataAsLanes, laneOffsetParallel)
+            #if defined(KeccakP1600times8_useTransposedLoads)
+            ADD_TRANSPOSED21_64(dataAsLanes, laneOffsetParallel, allLanes, firstFiveLanes)
+            #else
             #define Add_In( argLane, argIndex )  argLane = XOR(argLane, LOAD_GATHER8_64(index, dataAsLanes+argIndex))
             Add_In( _ba, 0 );
             Add_In( _be, 1 );
@@ -475,6 +661,7 @@ size_t KeccakP1600times8_12rounds_FastLoop_Absorb(void *states, unsigned int lan
             Add_In( _mu, 19 );
             Add_In( _sa, 20 );
             #undef  Add_In
+            #endif
             rounds12;
             dataAsLanes += laneOffsetSerial;
             dataByteLen -= laneOffsetSerial*8;
@@ -494,3 +681,162 @@ size_t KeccakP1600times8_12rounds_FastLoop_Absorb(void *states, unsigned int lan
         return data - dataStart;
     }
 }
+
+/* KangarooTwelve leaves: 8192 bytes = 48 blocks of 21 lanes + 16 lanes, suffix 0x0B, 32-byte chaining values */
+#define LeafCVs_chunkLanes      (8192/8)
+#define LeafCVs_fullBlocks      (8192/168)
+
+/* The instances not in the mask read no data and write no chaining value */
+static void KeccakP1600times8_12rounds_LeafCVsMasked(const unsigned char *data, __mmask8 mask, unsigned char *chainingValues)
+{
+    #if !defined(KeccakP1600times8_fullUnrolling) && (KeccakP1600times8_unrolling < 12)
+    unsigned int i;
+    #endif
+    const uint64_t *dataAsLanes = (const uint64_t *)data;
+    uint64_t *cvsAsLanes = (uint64_t *)chainingValues;
+    const uint64_t suffix = 0x0B;
+    const uint64_t padding = 0x8000000000000000ULL;
+    unsigned int j;
+    KeccakP_DeclareVars;
+    #if !defined(KeccakP1600times8_useTransposedLoads) || !defined(KeccakP1600times8_useTransposedStores)
+    V256 index;
+    #endif
+
+    #if defined(KeccakP1600times8_useTransposedLoads)
+    /* The instances not in the mask load nothing */
+    #define instanceLanes(k)        (__mmask8)((((mask) >> (k)) & 1) ? 0xFF : 0x00)
+    #define instanceFiveLanes(k)    (__mmask8)((((mask) >> (k)) & 1) ? 0x1F : 0x00)
+    _ba = _be = _bi = _bo = _bu = _mm512_setzero_si512();
+    _ga = _ge = _gi = _go = _gu = _mm512_setzero_si512();
+    _ka = _ke = _ki = _ko = _ku = _mm512_setzero_si512();
+    _ma = _me = _mi = _mo = _mu = _mm512_setzero_si512();
+    _sa = _se = _si = _so = _su = _mm512_setzero_si512();
+    for(j=0; j<LeafCVs_fullBlocks; j++) {
+        PREFETCH8_64(dataAsLanes, LeafCVs_chunkLanes)
+        ADD_TRANSPOSED21_64(dataAsLanes, LeafCVs_chunkLanes, instanceLanes, instanceFiveLanes)
+        rounds12;
+        dataAsLanes += 21;
+    }
+
+    /* Last block: 16 lanes of data, then the suffix and the padding */
+    ADD_TRANSPOSED8_64(_ba, _be, _bi, _bo, _bu, _ga, _ge, _gi, dataAsLanes+0, LeafCVs_chunkLanes, instanceLanes)
+    ADD_TRANSPOSED8_64(_go, _gu, _ka, _ke, _ki, _ko, _ku, _ma, dataAsLanes+8, LeafCVs_chunkLanes, instanceLanes)
+    #undef  instanceLanes
+    #undef  instanceFiveLanes
+    #else
+    index = LOAD8_32(7*LeafCVs_chunkLanes, 6*LeafCVs_chunkLanes, 5*LeafCVs_chunkLanes, 4*LeafCVs_chunkLanes, 3*LeafCVs_chunkLanes, 2*LeafCVs_chunkLanes, 1*LeafCVs_chunkLanes, 0*LeafCVs_chunkLanes);
+    #define Load_In( argLane, argIndex )  argLane = LOAD_MASK_GATHER8_64(mask, index, dataAsLanes+argIndex)
+    #define Add_In( argLane, argIndex )  argLane = XOR(argLane, LOAD_MASK_GATHER8_64(mask, index, dataAsLanes+argIndex))
+
+    /* First block: the state is still all zero */
+    PREFETCH8_64(dataAsLanes, LeafCVs_chunkLanes)
+    Load_In( _ba, 0 );
+    Load_In( _be, 1 );
+    Load_In( _bi, 2 );
+    Load_In( _bo, 3 );
+    Load_In( _bu, 4 );
+    Load_In( _ga, 5 );
+    Load_In( _ge, 6 );
+    Load_In( _gi, 7 );
+    Load_In( _go, 8 );
+    Load_In( _gu, 9 );
+    Load_In( _ka, 10 );
+    Load_In( _ke, 11 );
+    Load_In( _ki, 12 );
+    Load_In( _ko, 13 );
+    Load_In( _ku, 14 );
+    Load_In( _ma, 15 );
+    Load_In( _me, 16 );
+    Load_In( _mi, 17 );
+    Load_In( _mo, 18 );
+    Load_In( _mu, 19 );
+    Load_In( _sa, 20 );
+    _se = _mm512_setzero_si512();
+    _si = _mm512_setzero_si512();
+    _so = _mm512_setzero_si512();
+    _su = _mm512_setzero_si512();
+    rounds12;
+    dataAsLanes += 21;
+
+    for(j=1; j<LeafCVs_fullBlocks; j++) {
+        PREFETCH8_64(dataAsLanes, LeafCVs_chunkLanes)
+        Add_In( _ba, 0 );
+        Add_In( _be, 1 );
+        Add_In( _bi, 2 );
+        Add_In( _bo, 3 );
+        Add_In( _bu, 4 );
+        Add_In( _ga, 5 );
+        Add_In( _ge, 6 );
+        Add_In( _gi, 7 );
+        Add_In( _go, 8 );
+        Add_In( _gu, 9 );
+        Add_In( _ka, 10 );
+        Add_In( _ke, 11 );
+        Add_In( _ki, 12 );
+        Add_In( _ko, 13 );
+        Add_In( _ku, 14 );
+        Add_In( _ma, 15 );
+        Add_In( _me, 16 );
+        Add_In( _mi, 17 );
+        Add_In( _mo, 18 );
+        Add_In( _mu, 19 );
+        Add_In( _sa, 20 );
+        rounds12;
+        dataAsLanes += 21;
+    }
+
+    /* Last block: 16 lanes of data, then the suffix and the padding */
+    Add_In( _ba, 0 );
+    Add_In( _be, 1 );
+    Add_In( _bi, 2 );
+    Add_In( _bo, 3 );
+    Add_In( _bu, 4 );
+    Add_In( _ga, 5 );
+    Add_In( _ge, 6 );
+    Add_In( _gi, 7 );
+    Add_In( _go, 8 );
+    Add_In( _gu, 9 );
+    Add_In( _ka, 10 );
+    Add_In( _ke, 11 );
+    Add_In( _ki, 12 );
+    Add_In( _ko, 13 );
+    Add_In( _ku, 14 );
+    Add_In( _ma, 15 );
+    #undef  Load_In
+    #undef  Add_In
+    #endif
+    _me = XOR(_me, CONST8_64(suffix));
+    _sa = XOR(_sa, CONST8_64(padding));
+    rounds12;
+
+    /* The chaining values are the first 4 lanes of each instance */
+    #if defined(KeccakP1600times8_useTransposedStores)
+    STORE_TRANSPOSED4x8_64(cvsAsLanes, mask, _ba, _be, _bi, _bo)
+    #else
+    index = LOAD8_32(7*4, 6*4, 5*4, 4*4, 3*4, 2*4, 1*4, 0*4);
+    STORE_MASK_SCATTER8_64(cvsAsLanes+0, mask, index, _ba);
+    STORE_MASK_SCATTER8_64(cvsAsLanes+1, mask, index, _be);
+    STORE_MASK_SCATTER8_64(cvsAsLanes+2, mask, index, _bi);
+    STORE_MASK_SCATTER8_64(cvsAsLanes+3, mask, index, _bo);
+    #endif
+}
+
+void KeccakP1600times8_12rounds_LeafCVs(const unsigned char *data, unsigned char *chainingValues)
+{
+    KeccakP1600times8_12rounds_LeafCVsMasked(data, 0xFF, chainingValues);
+}
+
+void KeccakP1600times8_12rounds_PartialLeafCVs(const unsigned char *data, unsigned int leafCount, unsigned char *chainingValues)
+{
+    KeccakP1600times8_12rounds_LeafCVsMasked(data, (__mmask8)((1 << leafCount) - 1), chainingValues);
+}
+
+/* Out of the way of the ×16 in a single-translation-unit build */
+#undef XOR
+#undef XOR3
+#undef ROL
+#undef Chi
+#undef LOAD8_32
+#undef laneIndex
+#undef KeccakP_DeclareVars
+#undef KeccakP_4rounds
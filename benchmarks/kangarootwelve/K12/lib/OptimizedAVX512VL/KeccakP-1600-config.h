@@ -0,0 +1,21 @@
+#define KeccakP1600times2_implementation_config "SSE2, 2 rounds unrolled"
+#define KeccakP1600times2_unrolling 2
+#define KeccakP1600times2_useSSE
+#define KeccakP1600times2_useSSE2
+
+#define KeccakP1600times4_implementation_config "AVX512VL on 256-bit registers, 12 rounds unrolled"
+#define KeccakP1600times4_fullUnrolling
+#define KeccakP1600times4_useAVX512
+#define KeccakP1600times4_use256bitRegistersOnly
+/*
+#define KeccakP1600times4_prefetchDistance 512
+*/
+
+/* In addition, eight instances as two sets of four with their rounds interleaved. */
+/* With AVX-512VL, the 32 ymm registers leave room for the second set. */
+#define KeccakP1600times8_interleavedTimes4
+#define KeccakP1600times8_implementation_config "AVX512VL on 256-bit registers, two interleaved sets of 4, 12 rounds unrolled"
+#define KeccakP1600times8_useAVX512VL
+/*
+#define KeccakP1600times8_prefetchDistance 512
+*/
@@ -0,0 +1,22 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+/*
+AVX-512 implementation of Keccak-p[1600]x4, shared with OptimizedAVX512
+and built here with 256-bit registers only.
+*/
+
+#include "KeccakP-1600-SnP.h"
+#include "../OptimizedAVX512/KeccakP-1600-times4-SIMD512.c"
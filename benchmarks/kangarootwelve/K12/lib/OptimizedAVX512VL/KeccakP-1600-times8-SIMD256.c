@@ -0,0 +1,22 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+/*
+Keccak-p[1600]x8 as two interleaved sets of four, shared with OptimizedAVX2
+and built here with the AVX-512VL rotations and ternary logic.
+*/
+
+#include "KeccakP-1600-SnP.h"
+#include "../OptimizedAVX2/KeccakP-1600-times8-SIMD256.c"
@@ -0,0 +1,19 @@
+/*
+Implementation by Ronny Van Keer, hereby denoted as "the implementer".
+
+For more information, feedback or questions, please refer to our website:
+https://keccak.team/
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+
+---
+
+Please refer to the XKCP for more details.
+*/
+
+#define PlSnP_parallelism   4
+#define PlSnP_prefix(name)  KeccakP1600times4_##name
+
+#include "KeccakP-1600-timesN-vector.inc"
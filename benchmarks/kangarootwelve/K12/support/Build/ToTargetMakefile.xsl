@@ -16,6 +16,7 @@ http://creativecommons.org/publicdomain/zero/1.0/
 <xsl:key name="I" match="I" use="."/>
 <xsl:key name="h" match="h" use="."/>
 <xsl:key name="c" match="c" use="."/>
+<xsl:key name="inc" match="inc" use="."/>
 
 <xsl:output method="text" indent="no" encoding="UTF-8"/>
 
@@ -87,6 +88,58 @@ http://creativecommons.org/publicdomain/zero/1.0/
     </xsl:if>
 </xsl:template>
 
+<!-- Sources included by other sources instead of being compiled or installed on their own -->
+<xsl:template match="inc">
+    <xsl:if test="generate-id()=generate-id(key('inc', .)[1])">
+        <xsl:text>INCLUDED := $(INCLUDED) </xsl:text>
+        <xsl:value-of select="."/>
+        <xsl:text>
+</xsl:text>
+        <xsl:text>SOURCES := $(SOURCES) </xsl:text>
+        <xsl:value-of select="."/>
+        <xsl:text>
+
+</xsl:text>
+    </xsl:if>
+</xsl:template>
+
+<!-- In a target with <amalgamate/>, the C sources without their own flags are included in a single translation unit -->
+<xsl:template match="c[../amalgamate][not(@gcc)][substring(., string-length(.)-1, 2)='.c']">
+    <xsl:if test="generate-id()=generate-id(key('c', .)[1])">
+        <xsl:text>SOURCES := $(SOURCES) </xsl:text>
+        <xsl:value-of select="."/>
+        <xsl:text>
+AMALGAMATED := $(AMALGAMATED) </xsl:text>
+        <xsl:value-of select="."/>
+        <xsl:text>
+
+</xsl:text>
+    </xsl:if>
+</xsl:template>
+
+<xsl:template match="amalgamate">
+    <xsl:variable name="name">
+        <xsl:text>$(BINDIR)/</xsl:text>
+        <xsl:call-template name="getFileNameWithoutExtension">
+            <xsl:with-param name="fullPath" select="../@name"/>
+        </xsl:call-template>
+    </xsl:variable>
+    <xsl:value-of select="$name"/>
+    <xsl:text>.c: $(MAKEFILE_LIST) | $(BINDIR)
+&#9;printf '#include "%s"\n' $(AMALGAMATED) > $@
+</xsl:text>
+    <xsl:value-of select="$name"/>
+    <xsl:text>.o: </xsl:text>
+    <xsl:value-of select="$name"/>
+    <xsl:text>.c $(AMALGAMATED) $(HEADERS) $(INCLUDED)
+&#9;$(CC) $(INCLUDES) $(CFLAGS) -iquote . -c $&lt; -o $@
+OBJECTS := $(OBJECTS) </xsl:text>
+    <xsl:value-of select="$name"/>
+    <xsl:text>.o
+
+</xsl:text>
+</xsl:template>
+
 <xsl:template match="c">
     <xsl:if test="generate-id()=generate-id(key('c', .)[1])">
         <xsl:text>SOURCES := $(SOURCES) </xsl:text>
@@ -103,8 +156,13 @@ http://creativecommons.org/publicdomain/zero/1.0/
         <xsl:value-of select="$object"/>
         <xsl:text>: </xsl:text>
         <xsl:value-of select="."/>
-        <xsl:text> $(HEADERS)
-&#9;$(CC) $(INCLUDES) $(CFLAGS) -c $&lt; -o $@
+        <xsl:text> $(HEADERS) $(INCLUDED)
+&#9;$(CC) $(INCLUDES) $(CFLAGS) </xsl:text>
+        <xsl:if test="@gcc">
+            <xsl:value-of select="@gcc"/>
+            <xsl:text> </xsl:text>
+        </xsl:if>
+        <xsl:text>-c $&lt; -o $@
 OBJECTS := $(OBJECTS) </xsl:text>
         <xsl:value-of select="$object"/>
         <xsl:text>
@@ -153,7 +211,9 @@ AR = ar
 
     <xsl:apply-templates select="gcc|define|I"/>
     <xsl:apply-templates select="h"/>
+    <xsl:apply-templates select="inc"/>
     <xsl:apply-templates select="c"/>
+    <xsl:apply-templates select="amalgamate[1]"/>
 
     <xsl:text>bin/</xsl:text>
     <xsl:value-of select="@name"/>
@@ -107,6 +107,25 @@ static void performTestKangarooTwelveOneInput(unsigned int inputLen, unsigned in
             result =  KangarooTwelve_Final(&kt, output, customization, customLen);
             assert(result == 0);
         }
+        else if (mode == 3)
+        {
+            /* Buffered mode, random number of bytes per call */
+            ALIGN(64) static unsigned char stagingBuffer[KangarooTwelve_stagingBufferSize];
+            KangarooTwelve_Instance kt;
+            unsigned char *pInput = input;
+            result = KangarooTwelve_InitializeBuffered(&kt, outputLen, stagingBuffer);
+            assert(result == 0);
+            while (inputLen)
+            {
+                unsigned int len = ((rand() << 15) ^ rand()) % (inputLen + 1);
+                result = KangarooTwelve_Update(&kt, pInput, len);
+                assert(result == 0);
+                pInput += len;
+                inputLen -= len;
+            }
+            result =  KangarooTwelve_Final(&kt, output, customization, customLen);
+            assert(result == 0);
+        }
     }
     else
     {
@@ -156,6 +175,23 @@ static void performTestKangarooTwelveOneInput(unsigned int inputLen, unsigned in
                 assert(result == 0);
             }
         }
+        else if (mode == 3)
+        {
+            /* Buffered mode, 4096 bytes per call */
+            ALIGN(64) static unsigned char stagingBuffer[KangarooTwelve_stagingBufferSize];
+            KangarooTwelve_Instance kt;
+            result = KangarooTwelve_InitializeBuffered(&kt, 0, stagingBuffer);
+            assert(result == 0);
+            for (i = 0; i < inputLen; i += 4096)
+            {
+                result = KangarooTwelve_Update(&kt, input + i, (inputLen - i < 4096) ? (inputLen - i) : 4096);
+                assert(result == 0);
+            }
+            result = KangarooTwelve_Final(&kt, 0, customization, customLen);
+            assert(result == 0);
+            result = KangarooTwelve_Squeeze(&kt, output, outputLen);
+            assert(result == 0);
+        }
     }
 
     #ifdef VERBOSE
@@ -223,7 +259,7 @@ void selfTestKangarooTwelve(const unsigned char *expected)
     unsigned int mode, useSqueeze;
 
     for(useSqueeze = 0; useSqueeze <= 1; ++useSqueeze)
-    for(mode = 0; mode <= 2; ++mode) {
+    for(mode = 0; mode <= 3; ++mode) {
         #ifndef EMBEDDED
         printf("Testing KangarooTwelve %u %u...", useSqueeze, mode);
         fflush(stdout);
@@ -236,6 +272,657 @@ void selfTestKangarooTwelve(const unsigned char *expected)
     }
 }
 
+#if defined(KeccakP1600_isDispatched)
+/* Checks a few test vectors of the specification, from a single block to 174 leaves */
+static void selfTestKangarooTwelveVectors(void)
+{
+    static const unsigned char expectedPattern[6][32] = {
+        "\x2b\xda\x92\x45\x0e\x8b\x14\x7f\x8a\x7c\xb6\x29\xe7\x84\xa0\x58\xef\xca\x7c\xf7\xd8\x21\x8e\x02\xd3\x45\xdf\xaa\x65\x24\x4a\x1f",
+        "\x6b\xf7\x5f\xa2\x23\x91\x98\xdb\x47\x72\xe3\x64\x78\xf8\xe1\x9b\x0f\x37\x12\x05\xf6\xa9\xa9\x3a\x27\x3f\x51\xdf\x37\x12\x28\x88",
+        "\x0c\x31\x5e\xbc\xde\xdb\xf6\x14\x26\xde\x7d\xcf\x8f\xb7\x25\xd1\xe7\x46\x75\xd7\xf5\x32\x7a\x50\x67\xf3\x67\xb1\x08\xec\xb6\x7c",
+        "\xcb\x55\x2e\x2e\xc7\x7d\x99\x10\x70\x1d\x57\x8b\x45\x7d\xdf\x77\x2c\x12\xe3\x22\xe4\xee\x7f\xe4\x17\xf9\x2c\x75\x8f\x0d\x59\xd0",
+        "\x87\x01\x04\x5e\x22\x20\x53\x45\xff\x4d\xda\x05\x55\x5c\xbb\x5c\x3a\xf1\xa7\x71\xc2\xb8\x9b\xae\xf3\x7d\xb4\x3d\x99\x98\xb9\xfe",
+        "\x84\x4d\x61\x09\x33\xb1\xb9\x96\x3c\xbd\xeb\x5a\xe3\xb6\xb0\x5c\xc7\xcb\xd6\x7c\xee\xdf\x88\x3e\xb6\x78\xa0\xa8\xe0\x37\x16\x82" };
+    static const unsigned char expectedCustomization[3][32] = {
+        "\xfa\xb6\x58\xdb\x63\xe9\x4a\x24\x61\x88\xbf\x7a\xf6\x9a\x13\x30\x45\xf4\x6e\xe9\x84\xc5\x6e\x3c\x33\x28\xca\xaf\x1a\xa1\xa5\x83",
+        "\xd8\x48\xc5\x06\x8c\xed\x73\x6f\x44\x62\x15\x9b\x98\x67\xfd\x4c\x20\xb8\x08\xac\xc3\xd5\xbc\x48\xe0\xb0\x6b\xa0\xa3\x76\x2e\xc4",
+        "\xc3\x89\xe5\x00\x9a\xe5\x71\x20\x85\x4c\x2e\x8c\x64\x67\x0a\xc0\x13\x58\xcf\x4c\x1b\xaf\x89\x44\x7a\x72\x42\x34\xdc\x7c\xed\x74" };
+    unsigned char *M = (unsigned char *)malloc(17*17*17*17*17);
+    unsigned char C[41*41];
+    unsigned char output[32];
+    unsigned int i, j, l;
+    int result;
+
+    #ifndef EMBEDDED
+    printf("Testing KangarooTwelve test vectors...");
+    fflush(stdout);
+    #endif
+    assert(M != NULL);
+    result = KangarooTwelve(0, 0, output, 32, 0, 0);
+    assert(result == 0);
+    assert(memcmp(output, "\x1a\xc2\xd4\x50\xfc\x3b\x42\x05\xd1\x9d\xa7\xbf\xca\x1b\x37\x51\x3c\x08\x03\x57\x7a\xc7\x16\x7f\x06\xfe\x2c\xe1\xf0\xef\x39\xe5", 32) == 0);
+    for(l=1, i=0; i<6; i++, l=l*17) {
+        for(j=0; j<l; j++)
+            M[j] = j%251;
+        result = KangarooTwelve(M, l, output, 32, 0, 0);
+        assert(result == 0);
+        assert(memcmp(output, expectedPattern[i], 32) == 0);
+    }
+    for(l=1, i=0; i<3; i++, l=l*41) {
+        unsigned int ll = (1 << i)-1;
+        memset(M, 0xFF, ll);
+        for(j=0; j<l; j++)
+            C[j] = j%251;
+        result = KangarooTwelve(M, ll, output, 32, C, l);
+        assert(result == 0);
+        assert(memcmp(output, expectedCustomization[i], 32) == 0);
+    }
+    free(M);
+    #ifndef EMBEDDED
+    printf(" - OK.\n");
+    #endif
+}
+#endif
+
+/* Checks that KangarooTwelve_Batch() gives the same outputs as KangarooTwelve() */
+static void selfTestKangarooTwelveBatch(void)
+{
+    #define batchMaxCount 37
+    const size_t counts[] = { 0, 1, 8, 13, batchMaxCount };
+    const size_t outputLens[] = { 32, 64, 168, 169, outputByteSize };
+    const size_t customLens[] = { 0, 3, customizationByteSize };
+    unsigned char *inputs[batchMaxCount];
+    unsigned char *outputs[batchMaxCount];
+    size_t inputLens[batchMaxCount];
+    unsigned char customization[customizationByteSize];
+    unsigned char expected[outputByteSize];
+    unsigned int c, o, k;
+    size_t i;
+    int result;
+
+    #ifndef EMBEDDED
+    printf("Testing KangarooTwelve in batches...");
+    fflush(stdout);
+    #endif
+    generateSimpleRawMaterial(customization, customizationByteSize, 0x3C, 5);
+    for(i = 0; i < batchMaxCount; ++i) {
+        /* Mixed lengths around block and chunk boundaries, a few of them needing several nodes */
+        inputLens[i] = (i * 1031 + (i % 3) * 167) % (cChunkSize + 300);
+        inputs[i] = (unsigned char *)malloc(inputLens[i] + 1);
+        outputs[i] = (unsigned char *)malloc(outputByteSize);
+        assert((inputs[i] != NULL) && (outputs[i] != NULL));
+        generateSimpleRawMaterial(inputs[i], (unsigned int)inputLens[i], (unsigned char)i, (unsigned int)i);
+    }
+    for(c = 0; c < sizeof(counts)/sizeof(counts[0]); ++c)
+    for(o = 0; o < sizeof(outputLens)/sizeof(outputLens[0]); ++o)
+    for(k = 0; k < sizeof(customLens)/sizeof(customLens[0]); ++k) {
+        result = KangarooTwelve_Batch((const unsigned char * const *)inputs, inputLens, outputs, outputLens[o], counts[c], customization, customLens[k]);
+        assert(result == 0);
+        for(i = 0; i < counts[c]; ++i) {
+            result = KangarooTwelve(inputs[i], inputLens[i], expected, outputLens[o], customization, customLens[k]);
+            assert(result == 0);
+            assert(memcmp(expected, outputs[i], outputLens[o]) == 0);
+        }
+    }
+    for(i = 0; i < batchMaxCount; ++i) {
+        free(inputs[i]);
+        free(outputs[i]);
+    }
+    #ifndef EMBEDDED
+    printf(" - OK.\n");
+    #endif
+    #undef batchMaxCount
+}
+
+/* Checks that hashing resumes correctly from a state saved by KangarooTwelve_Export() */
+static void selfTestKangarooTwelveExport(void)
+{
+    const size_t lengths[] = { 0, 100, cChunkSize, cChunkSize+1, 3*cChunkSize+5, inputByteSize };
+    const size_t splits[] = { 0, 1, 167, 168, cChunkSize, cChunkSize+1, 2*cChunkSize+3000, 9*cChunkSize };
+    static unsigned char input[inputByteSize];
+    unsigned char expected[outputByteSize];
+    unsigned char output[outputByteSize];
+    unsigned char exported[KangarooTwelve_exportSize];
+    KangarooTwelve_Instance kt;
+    unsigned int l, s, buffered;
+    int result;
+
+    #ifndef EMBEDDED
+    printf("Testing KangarooTwelve export and import...");
+    fflush(stdout);
+    #endif
+    generateSimpleRawMaterial(input, inputByteSize, 0x7E, 11);
+    for(l = 0; l < sizeof(lengths)/sizeof(lengths[0]); ++l) {
+        result = KangarooTwelve(input, lengths[l], expected, outputByteSize, (const unsigned char *)"K12", 3);
+        assert(result == 0);
+        for(s = 0; s < sizeof(splits)/sizeof(splits[0]); ++s)
+        for(buffered = 0; buffered <= 1; ++buffered) {
+            /* Export after a first part, import in a scrambled instance, then absorb the rest */
+            ALIGN(64) static unsigned char stagingBuffer[KangarooTwelve_stagingBufferSize];
+            size_t split = (splits[s] < lengths[l]) ? splits[s] : lengths[l];
+            if (buffered)
+                result = KangarooTwelve_InitializeBuffered(&kt, 0, stagingBuffer);
+            else
+                result = KangarooTwelve_Initialize(&kt, 0);
+            assert(result == 0);
+            result = KangarooTwelve_Update(&kt, input, split);
+            assert(result == 0);
+            result = KangarooTwelve_Export(&kt, exported);
+            assert(result == 0);
+            if (buffered) {
+                /* The exporting instance stays usable */
+                result = KangarooTwelve_Update(&kt, input + split, lengths[l] - split);
+                assert(result == 0);
+                result = KangarooTwelve_Final(&kt, output, (const unsigned char *)"K12", 3);
+                assert(result == 0);
+                result = KangarooTwelve_Squeeze(&kt, output, outputByteSize);
+                assert(result == 0);
+                assert(memcmp(expected, output, outputByteSize) == 0);
+            }
+            memset(&kt, 0xA5, sizeof(kt));
+            result = KangarooTwelve_Import(exported, &kt);
+            assert(result == 0);
+            result = KangarooTwelve_Update(&kt, input + split, lengths[l] - split);
+            assert(result == 0);
+            result = KangarooTwelve_Final(&kt, output, (const unsigned char *)"K12", 3);
+            assert(result == 0);
+
+            /* Export again in the middle of squeezing */
+            result = KangarooTwelve_Squeeze(&kt, output, s);
+            assert(result == 0);
+            result = KangarooTwelve_Export(&kt, exported);
+            assert(result == 0);
+            memset(&kt, 0x5A, sizeof(kt));
+            result = KangarooTwelve_Import(exported, &kt);
+            assert(result == 0);
+            result = KangarooTwelve_Squeeze(&kt, output + s, outputByteSize - s);
+            assert(result == 0);
+            assert(memcmp(expected, output, outputByteSize) == 0);
+        }
+    }
+
+    /* Unknown versions are rejected */
+    exported[3] ^= 0xFF;
+    result = KangarooTwelve_Import(exported, &kt);
+    assert(result == 1);
+
+    /* So are fields that do not agree with each other: after the first chunk and a bit more,
+       blockNumber is 1, queueAbsorbedLen is 100, pendingCVsLen is 0 and the final node is at byte 136 */
+    result = KangarooTwelve_Initialize(&kt, 0);
+    assert(result == 0);
+    result = KangarooTwelve_Update(&kt, input, cChunkSize + 100);
+    assert(result == 0);
+    result = KangarooTwelve_Export(&kt, exported);
+    assert(result == 0);
+    assert((exported[13] == 1) && (exported[21] == 100) && (exported[23] == 0) && (exported[224] == 136));
+    exported[23] = 33; /* pendingCVsLen past the end of the block */
+    result = KangarooTwelve_Import(exported, &kt);
+    assert(result == 1);
+    exported[23] = 32;
+    result = KangarooTwelve_Import(exported, &kt);
+    assert(result == 0);
+    exported[13] = 0; /* Chaining values before the first chunk is closed */
+    result = KangarooTwelve_Import(exported, &kt);
+    assert(result == 1);
+    exported[13] = 1;
+    exported[21] = 0x00; /* A complete leaf in the queue */
+    exported[22] = 0x20;
+    result = KangarooTwelve_Import(exported, &kt);
+    assert(result == 1);
+    #ifndef EMBEDDED
+    printf(" - OK.\n");
+    #endif
+}
+
+/* Checks that switching to and from buffered mode while absorbing does not change the output */
+static void selfTestKangarooTwelveStaging(void)
+{
+    const size_t pieceLens[] = { 1500, 1, cChunkSize-1, cChunkSize+1, 3*cChunkSize+7 };
+    const size_t switchPeriods[] = { 1, 2, 5, 11 };
+    static unsigned char input[inputByteSize];
+    ALIGN(64) static unsigned char stagingBuffer[KangarooTwelve_stagingBufferSize];
+    unsigned char expected[outputByteSize];
+    unsigned char output[outputByteSize];
+    KangarooTwelve_Instance kt;
+    unsigned int p, s, buffered;
+    int result;
+
+    #ifndef EMBEDDED
+    printf("Testing KangarooTwelve switching to and from buffered mode...");
+    fflush(stdout);
+    #endif
+    generateSimpleRawMaterial(input, inputByteSize, 0x66, 23);
+    result = KangarooTwelve(input, inputByteSize, expected, outputByteSize, (const unsigned char *)"K12", 3);
+    assert(result == 0);
+    for(p = 0; p < sizeof(pieceLens)/sizeof(pieceLens[0]); ++p)
+    for(s = 0; s < sizeof(switchPeriods)/sizeof(switchPeriods[0]); ++s) {
+        /* Give the input in pieces, and switch modes every few pieces, mostly in the middle of a leaf */
+        size_t offset = 0, pieceCount = 0;
+
+        buffered = s & 1;
+        if (buffered)
+            result = KangarooTwelve_InitializeBuffered(&kt, 0, stagingBuffer);
+        else
+            result = KangarooTwelve_Initialize(&kt, 0);
+        assert(result == 0);
+        while ( offset < inputByteSize ) {
+            size_t len = (inputByteSize - offset < pieceLens[p]) ? (inputByteSize - offset) : pieceLens[p];
+            if ( (pieceCount > 0) && (pieceCount % switchPeriods[s] == 0) ) {
+                buffered = !buffered;
+                result = KangarooTwelve_SetStagingBuffer(&kt, buffered ? stagingBuffer : NULL);
+                assert(result == 0);
+            }
+            result = KangarooTwelve_Update(&kt, input + offset, len);
+            assert(result == 0);
+            offset += len;
+            ++pieceCount;
+        }
+        result = KangarooTwelve_Final(&kt, output, (const unsigned char *)"K12", 3);
+        assert(result == 0);
+        result = KangarooTwelve_Squeeze(&kt, output, outputByteSize);
+        assert(result == 0);
+        assert(memcmp(expected, output, outputByteSize) == 0);
+
+        /* The mode is fixed once the input is complete */
+        result = KangarooTwelve_SetStagingBuffer(&kt, stagingBuffer);
+        assert(result == 1);
+    }
+    #ifndef EMBEDDED
+    printf(" - OK.\n");
+    #endif
+}
+
+/* Checks that KangarooTwelve_Rehash() gives the same output as hashing the changed input from scratch */
+static void selfTestKangarooTwelveRehash(void)
+{
+    const size_t lengths[] = { 100, cChunkSize, 9*cChunkSize-5, 20*cChunkSize+100, 37*cChunkSize };
+    const size_t customLens[] = { 0, customizationByteSize };
+    const size_t maxLength = 37*cChunkSize;
+    const size_t maxLeafCount = 38;
+    unsigned char *input = (unsigned char *)malloc(maxLength);
+    unsigned char *chainingValues = (unsigned char *)malloc(maxLeafCount*32);
+    unsigned char *expectedChainingValues = (unsigned char *)malloc(maxLeafCount*32);
+    unsigned char customization[customizationByteSize];
+    unsigned char expected[outputByteSize];
+    unsigned char output[outputByteSize];
+    unsigned int l, k, c;
+    int result;
+
+    #ifndef EMBEDDED
+    printf("Testing KangarooTwelve rehash...");
+    fflush(stdout);
+    #endif
+    assert((input != NULL) && (chainingValues != NULL) && (expectedChainingValues != NULL));
+    generateSimpleRawMaterial(customization, customizationByteSize, 0x1D, 7);
+    for(l = 0; l < sizeof(lengths)/sizeof(lengths[0]); ++l)
+    for(k = 0; k < sizeof(customLens)/sizeof(customLens[0]); ++k) {
+        size_t leafCount = KangarooTwelve_LeafCount(lengths[l], customLens[k]);
+        KangarooTwelve_Instance kt;
+        size_t changedChunks[4][12];
+        size_t changedCounts[4] = { 1, 1, 10, 3 };
+        size_t i;
+
+        /* The first chunk, the last one, a run of more than 8, and a few out of order */
+        changedChunks[0][0] = 0;
+        changedChunks[1][0] = leafCount;
+        for(i = 0; i < 10; ++i)
+            changedChunks[2][i] = (i + 1 <= leafCount) ? (i + 1) : leafCount;
+        changedChunks[3][0] = (5 <= leafCount) ? 5 : leafCount;
+        changedChunks[3][1] = leafCount;
+        changedChunks[3][2] = (leafCount > 1) ? 1 : leafCount;
+
+        generateSimpleRawMaterial(input, lengths[l], (unsigned char)l, 3);
+        result = KangarooTwelve_Initialize(&kt, outputByteSize);
+        assert(result == 0);
+        result = KangarooTwelve_SetChainingValueSink(&kt, chainingValues, leafCount);
+        assert(result == 0);
+        result = KangarooTwelve_Update(&kt, input, lengths[l]);
+        assert(result == 0);
+        result = KangarooTwelve_Final(&kt, output, customization, customLens[k]);
+        assert(result == 0);
+        result = KangarooTwelve(input, lengths[l], expected, outputByteSize, customization, customLens[k]);
+        assert(result == 0);
+        assert(memcmp(expected, output, outputByteSize) == 0);
+
+        for(c = 0; c < 4; ++c) {
+            /* Change one byte in each of the given chunks that overlap the input */
+            for(i = 0; i < changedCounts[c]; ++i) {
+                size_t offset = changedChunks[c][i]*cChunkSize + 77;
+                if (offset < lengths[l])
+                    input[offset] ^= (unsigned char)(c + 1);
+            }
+            result = KangarooTwelve_Rehash(input, lengths[l], chainingValues, changedChunks[c], changedCounts[c], output, outputByteSize, customization, customLens[k]);
+            assert(result == 0);
+            result = KangarooTwelve(input, lengths[l], expected, outputByteSize, customization, customLens[k]);
+            assert(result == 0);
+            assert(memcmp(expected, output, outputByteSize) == 0);
+
+            /* The chaining values are up to date for the next changes */
+            result = KangarooTwelve_Initialize(&kt, outputByteSize);
+            assert(result == 0);
+            result = KangarooTwelve_SetChainingValueSink(&kt, expectedChainingValues, leafCount);
+            assert(result == 0);
+            result = KangarooTwelve_Update(&kt, input, lengths[l]);
+            assert(result == 0);
+            result = KangarooTwelve_Final(&kt, output, customization, customLens[k]);
+            assert(result == 0);
+            assert(memcmp(expectedChainingValues, chainingValues, leafCount*32) == 0);
+        }
+
+        /* Chunks beyond the message are rejected, and so is a sink too small */
+        changedChunks[0][0] = leafCount + 1;
+        result = KangarooTwelve_Rehash(input, lengths[l], chainingValues, changedChunks[0], 1, output, outputByteSize, customization, customLens[k]);
+        assert(result == 1);
+        if (leafCount > 0) {
+            result = KangarooTwelve_Initialize(&kt, outputByteSize);
+            assert(result == 0);
+            result = KangarooTwelve_SetChainingValueSink(&kt, chainingValues, leafCount - 1);
+            assert(result == 0);
+            result = KangarooTwelve_Update(&kt, input, lengths[l]);
+            assert(result == 0);
+            result = KangarooTwelve_Final(&kt, output, customization, customLens[k]);
+            assert(result == 1);
+        }
+    }
+    free(input);
+    free(chainingValues);
+    free(expectedChainingValues);
+    #ifndef EMBEDDED
+    printf(" - OK.\n");
+    #endif
+}
+
+/* Checks that a KangarooTwelve_Verifier accepts the authentic input in pieces of any size and rejects any change */
+static void selfTestKangarooTwelveOutboard(void)
+{
+    const size_t lengths[] = { 0, 100, cChunkSize-20, cChunkSize, 9*cChunkSize-5, 20*cChunkSize+100 };
+    const size_t pieceLens[] = { 1000, cChunkSize, 8*cChunkSize+5, 20*cChunkSize+100 };
+    const size_t hashLens[] = { 32, outputByteSize };
+    const size_t maxLength = 20*cChunkSize+100;
+    const size_t maxLeafCount = 21;
+    unsigned char *input = (unsigned char *)malloc(maxLength);
+    unsigned char *outboard = (unsigned char *)malloc(maxLeafCount*32);
+    unsigned char customization[customizationByteSize];
+    unsigned char hash[outputByteSize];
+    unsigned int l, p, h, tamper;
+    int result;
+
+    #ifndef EMBEDDED
+    printf("Testing KangarooTwelve outboard verification...");
+    fflush(stdout);
+    #endif
+    assert((input != NULL) && (outboard != NULL));
+    generateSimpleRawMaterial(customization, customizationByteSize, 0x2B, 9);
+    for(l = 0; l < sizeof(lengths)/sizeof(lengths[0]); ++l)
+    for(h = 0; h < sizeof(hashLens)/sizeof(hashLens[0]); ++h) {
+        size_t leafCount = KangarooTwelve_LeafCount(lengths[l], customizationByteSize);
+        generateSimpleRawMaterial(input, lengths[l], (unsigned char)(l + 0x40), 5);
+        result = KangarooTwelve_EncodeOutboard(input, lengths[l], outboard, hash, hashLens[h], customization, customizationByteSize);
+        assert(result == 0);
+        result = KangarooTwelve(input, lengths[l], hash + outputByteSize - hashLens[h], hashLens[h], customization, customizationByteSize);
+        assert(result == 0);
+        assert(memcmp(hash, hash + outputByteSize - hashLens[h], hashLens[h]) == 0);
+
+        /* 0: authentic, 1: changed input in the last chunk, 2: changed outboard, 3: changed hash */
+        for(tamper = 0; tamper <= 3; ++tamper)
+        for(p = 0; p < sizeof(pieceLens)/sizeof(pieceLens[0]); ++p) {
+            KangarooTwelve_Verifier verifier;
+            size_t offset = 0;
+
+            if ( ((tamper == 1) && (lengths[l] == 0)) || ((tamper == 2) && (leafCount == 0)) )
+                continue;
+            if (tamper == 1)
+                input[lengths[l] - 1] ^= 0x01;
+            if (tamper == 2)
+                outboard[leafCount*32 - 1] ^= 0x01;
+            if (tamper == 3)
+                hash[0] ^= 0x01;
+            result = KangarooTwelve_VerifierInitialize(&verifier, lengths[l], outboard, hash, hashLens[h], customization, customizationByteSize);
+            assert(result == 0);
+            while ( offset < lengths[l] ) {
+                size_t len = (lengths[l] - offset < pieceLens[p]) ? (lengths[l] - offset) : pieceLens[p];
+                result |= KangarooTwelve_VerifierUpdate(&verifier, input + offset, len);
+                offset += len;
+            }
+            result |= KangarooTwelve_VerifierFinal(&verifier);
+            assert(result == ((tamper == 0) ? 0 : 1));
+            if (tamper == 1)
+                input[lengths[l] - 1] ^= 0x01;
+            if (tamper == 2)
+                outboard[leafCount*32 - 1] ^= 0x01;
+            if (tamper == 3)
+                hash[0] ^= 0x01;
+        }
+    }
+    free(input);
+    free(outboard);
+    #ifndef EMBEDDED
+    printf(" - OK.\n");
+    #endif
+}
+
+#if !defined(EMBEDDED)
+#include <pthread.h>
+#include <unistd.h>
+#include "KangarooTwelveFile.h"
+
+#define testThreadCount 4
+
+typedef struct {
+    void (*job)(void *jobContext, size_t jobIndex);
+    void *jobContext;
+    size_t jobCount;
+    size_t nextJob;
+    pthread_mutex_t mutex;
+} TestThreadPoolRound;
+
+static void *testThreadPoolWorker(void *context)
+{
+    TestThreadPoolRound *round = (TestThreadPoolRound *)context;
+
+    for ( ; ; ) {
+        size_t jobIndex;
+        pthread_mutex_lock(&round->mutex);
+        jobIndex = round->nextJob++;
+        pthread_mutex_unlock(&round->mutex);
+        if (jobIndex >= round->jobCount)
+            return NULL;
+        round->job(round->jobContext, jobIndex);
+    }
+}
+
+/* Minimalistic thread pool: starts fresh threads for each round of jobs */
+static void testThreadPoolRun(void *poolContext, void (*job)(void *jobContext, size_t jobIndex), void *jobContext, size_t jobCount)
+{
+    pthread_t threads[testThreadCount];
+    TestThreadPoolRound round;
+    unsigned int i;
+    int result;
+
+    (void)poolContext;
+    round.job = job;
+    round.jobContext = jobContext;
+    round.jobCount = jobCount;
+    round.nextJob = 0;
+    pthread_mutex_init(&round.mutex, NULL);
+    for(i=0; i<testThreadCount; i++) {
+        result = pthread_create(&threads[i], NULL, testThreadPoolWorker, &round);
+        assert(result == 0);
+    }
+    for(i=0; i<testThreadCount; i++)
+        pthread_join(threads[i], NULL);
+    pthread_mutex_destroy(&round.mutex);
+}
+
+/* Checks that KangarooTwelve_UpdateParallel() gives the same output as KangarooTwelve() */
+static void selfTestKangarooTwelveParallel(void)
+{
+    const KangarooTwelve_ThreadPool threadPool = { NULL, testThreadPoolRun };
+    const size_t lengths[] = { 0, 1, cChunkSize, 65*cChunkSize, 65*cChunkSize+1, 130*cChunkSize-1, 4100*cChunkSize+3333 };
+    const size_t splits[] = { 0, 1, cChunkSize-1, cChunkSize, cChunkSize+1, 3*cChunkSize+100, 9*cChunkSize };
+    const size_t maxLength = 4100*cChunkSize+3333;
+    unsigned char *input = (unsigned char *)malloc(maxLength);
+    unsigned char expected[outputByteSize];
+    unsigned char output[outputByteSize];
+    unsigned int l, s, usePool, buffered;
+    int result;
+
+    printf("Testing KangarooTwelve with threads...");
+    fflush(stdout);
+    assert(input != NULL);
+    generateSimpleRawMaterial(input, maxLength, 0x5A, 3);
+    for(l = 0; l < sizeof(lengths)/sizeof(lengths[0]); ++l) {
+        result = KangarooTwelve(input, lengths[l], expected, outputByteSize, (const unsigned char *)"K12", 3);
+        assert(result == 0);
+        for(s = 0; s < sizeof(splits)/sizeof(splits[0]); ++s)
+        for(usePool = 0; usePool <= 1; ++usePool)
+        for(buffered = 0; buffered <= 1; ++buffered) {
+            /* Serial update of a first part, then parallel update of the rest */
+            ALIGN(64) static unsigned char stagingBuffer[KangarooTwelve_stagingBufferSize];
+            KangarooTwelve_Instance kt;
+            size_t split = (splits[s] < lengths[l]) ? splits[s] : lengths[l];
+            if (buffered)
+                result = KangarooTwelve_InitializeBuffered(&kt, outputByteSize, stagingBuffer);
+            else
+                result = KangarooTwelve_Initialize(&kt, outputByteSize);
+            assert(result == 0);
+            result = KangarooTwelve_Update(&kt, input, split);
+            assert(result == 0);
+            result = KangarooTwelve_UpdateParallel(&kt, input + split, lengths[l] - split, usePool ? &threadPool : NULL);
+            assert(result == 0);
+            result = KangarooTwelve_Final(&kt, output, (const unsigned char *)"K12", 3);
+            assert(result == 0);
+            assert(memcmp(expected, output, outputByteSize) == 0);
+        }
+    }
+    free(input);
+    printf(" - OK.\n");
+}
+
+/* Checks that KangarooTwelve_HashFile() gives the same output as KangarooTwelve() on the contents */
+static void selfTestKangarooTwelveFile(void)
+{
+    const size_t lengths[] = { 0, 100, 64*1024-1, 64*1024, 300*cChunkSize+7, 2*1024*1024+8*cChunkSize };
+    const size_t maxLength = 300*cChunkSize+7;
+    unsigned char *input = (unsigned char *)malloc(maxLength);
+    unsigned char expected[outputByteSize];
+    unsigned char output[outputByteSize];
+    char path[] = "/tmp/K12TestsXXXXXX";
+    unsigned int l;
+    int fd, result;
+    ssize_t writtenLen;
+
+    printf("Testing KangarooTwelve on files...");
+    fflush(stdout);
+    assert(input != NULL);
+    generateSimpleRawMaterial(input, maxLength, 0x33, 13);
+    fd = mkstemp(path);
+    assert(fd >= 0);
+    for(l = 0; l < sizeof(lengths)/sizeof(lengths[0]); ++l) {
+        result = ftruncate(fd, 0);
+        assert(result == 0);
+        writtenLen = pwrite(fd, input, lengths[l], 0);
+        assert(writtenLen == (ssize_t)lengths[l]);
+        result = KangarooTwelve(input, lengths[l], expected, outputByteSize, (const unsigned char *)"file", 4);
+        assert(result == 0);
+        result = KangarooTwelve_HashFile(path, output, outputByteSize, (const unsigned char *)"file", 4);
+        assert(result == 0);
+        assert(memcmp(expected, output, outputByteSize) == 0);
+    }
+    close(fd);
+    unlink(path);
+    result = KangarooTwelve_HashFile(path, output, outputByteSize, NULL, 0);
+    assert(result == 1);
+    free(input);
+    printf(" - OK.\n");
+}
+
+typedef struct {
+    int fd;
+    const unsigned char *data;
+    size_t len;
+} TestPipeWriter;
+
+/* Writes the data to the pipe in uneven pieces, then closes it */
+static void *testPipeWriter(void *context)
+{
+    TestPipeWriter *writer = (TestPipeWriter *)context;
+    size_t offset = 0, pieceLen = 1;
+
+    while ( offset < writer->len ) {
+        size_t len = (writer->len - offset < pieceLen) ? (writer->len - offset) : pieceLen;
+        ssize_t writtenLen = write(writer->fd, writer->data + offset, len);
+        assert(writtenLen > 0);
+        offset += (size_t)writtenLen;
+        pieceLen = (pieceLen * 7 + 1000) % 100000;
+    }
+    close(writer->fd);
+    return NULL;
+}
+
+/* Checks that KangarooTwelve_HashFd() gives the same output as KangarooTwelve() on what it reads */
+static void selfTestKangarooTwelveFd(void)
+{
+    const size_t lengths[] = { 0, 100, 1024*1024-cChunkSize, 1024*1024, 5*1024*1024+3*cChunkSize+1 };
+    const size_t maxLength = 5*1024*1024+3*cChunkSize+1;
+    unsigned char *input = (unsigned char *)malloc(maxLength);
+    unsigned char expected[outputByteSize];
+    unsigned char output[outputByteSize];
+    char path[] = "/tmp/K12TestsXXXXXX";
+    unsigned int l;
+    int fd, result;
+    ssize_t writtenLen;
+    off_t offset;
+
+    printf("Testing KangarooTwelve on file descriptors...");
+    fflush(stdout);
+    assert(input != NULL);
+    generateSimpleRawMaterial(input, maxLength, 0x44, 17);
+    fd = mkstemp(path);
+    assert(fd >= 0);
+    unlink(path);
+    for(l = 0; l < sizeof(lengths)/sizeof(lengths[0]); ++l) {
+        TestPipeWriter writer;
+        pthread_t thread;
+        int fds[2];
+
+        result = KangarooTwelve(input, lengths[l], expected, outputByteSize, (const unsigned char *)"fd", 2);
+        assert(result == 0);
+
+        /* Regular file */
+        result = ftruncate(fd, 0);
+        assert(result == 0);
+        writtenLen = pwrite(fd, input, lengths[l], 0);
+        assert(writtenLen == (ssize_t)lengths[l]);
+        offset = lseek(fd, 0, SEEK_SET);
+        assert(offset == 0);
+        result = KangarooTwelve_HashFd(fd, output, outputByteSize, (const unsigned char *)"fd", 2);
+        assert(result == 0);
+        assert(memcmp(expected, output, outputByteSize) == 0);
+
+        /* Pipe */
+        result = pipe(fds);
+        assert(result == 0);
+        writer.fd = fds[1];
+        writer.data = input;
+        writer.len = lengths[l];
+        result = pthread_create(&thread, NULL, testPipeWriter, &writer);
+        assert(result == 0);
+        result = KangarooTwelve_HashFd(fds[0], output, outputByteSize, (const unsigned char *)"fd", 2);
+        assert(result == 0);
+        result = pthread_join(thread, NULL);
+        assert(result == 0);
+        close(fds[0]);
+        assert(memcmp(expected, output, outputByteSize) == 0);
+    }
+    close(fd);
+    result = KangarooTwelve_HashFd(-1, output, outputByteSize, NULL, 0);
+    assert(result == 1);
+    free(input);
+    printf(" - OK.\n");
+}
+#endif
+
 #ifdef OUTPUT
 void writeTestKangarooTwelveOne(FILE *f)
 {
@@ -314,5 +1001,54 @@ void testKangarooTwelve(void)
     writeTestKangarooTwelve("KangarooTwelve.txt");
 #endif
 
+#if defined(KeccakP1600_isDispatched)
+    {
+        KeccakP1600_DispatchLevel level;
+        KeccakP1600_DispatchLevel supportedLevel = KeccakP1600_GetSupportedDispatchLevel();
+        int result;
+
+        /* Test every set of implementations the processor can run, then restore the widest one */
+        for(level = KeccakP1600_dispatchGeneric64; level <= supportedLevel; ++level) {
+            result = KeccakP1600_SetDispatchLevel(level);
+            assert(result == 0);
+            #ifndef EMBEDDED
+            printf("Runtime dispatch level %u (\303\2272: %s, \303\2274: %s, \303\2278: %s)\n", (unsigned int)level,
+                KeccakP1600times2_implementation, KeccakP1600times4_implementation, KeccakP1600times8_implementation);
+            #endif
+            selfTestKangarooTwelve((const unsigned char *)"\x61\x4d\x7a\xf8\xd5\xcc\xd0\xe1\x02\x53\x7d\x21\x5e\x39\x05\xed");
+        }
+        result = KeccakP1600_SetDispatchLevel(supportedLevel);
+        assert(result == 0);
+    }
+    {
+        KeccakP1600_Variant variant;
+        KeccakP1600_Variant selectedVariant = KeccakP1600_GetVariant();
+        int result;
+
+        /* Test every variant of the single-instance permutation on the test vectors only, as the dispatch levels
+           above already ran the full test with the selected one, then restore it */
+        for(variant = KeccakP1600_variantUnrolled; variant < KeccakP1600_variantCount; ++variant) {
+            result = KeccakP1600_SetVariant(variant);
+            assert(result == 0);
+            #ifndef EMBEDDED
+            printf("Single-instance variant %u (%s)\n", (unsigned int)variant, KeccakP1600_implementation);
+            #endif
+            selfTestKangarooTwelveVectors();
+        }
+        result = KeccakP1600_SetVariant(selectedVariant);
+        assert(result == 0);
+    }
+#else
     selfTestKangarooTwelve((const unsigned char *)"\x61\x4d\x7a\xf8\xd5\xcc\xd0\xe1\x02\x53\x7d\x21\x5e\x39\x05\xed");
+#endif
+    selfTestKangarooTwelveBatch();
+    selfTestKangarooTwelveExport();
+    selfTestKangarooTwelveStaging();
+    selfTestKangarooTwelveRehash();
+    selfTestKangarooTwelveOutboard();
+#if !defined(EMBEDDED)
+    selfTestKangarooTwelveParallel();
+    selfTestKangarooTwelveFile();
+    selfTestKangarooTwelveFd();
+#endif
 }
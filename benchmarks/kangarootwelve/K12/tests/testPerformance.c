@@ -14,6 +14,7 @@ http://creativecommons.org/publicdomain/zero/1.0/
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "KangarooTwelve.h"
 #include "timing.h"
@@ -39,17 +40,88 @@ uint_32t measureKangarooTwelve(uint_32t dtMin, unsigned int inputLen)
     measureTimingEnd
 }
 
+uint_32t measureKangarooTwelveStreaming(uint_32t dtMin, unsigned int inputLen, unsigned int writeLen, int buffered)
+{
+    ALIGN(64) static unsigned char input[1024*1024];
+    ALIGN(64) static unsigned char stagingBuffer[KangarooTwelve_stagingBufferSize];
+    ALIGN(32) unsigned char output[32];
+    KangarooTwelve_Instance kt;
+    unsigned int j;
+    measureTimingDeclare
+
+    assert(inputLen <= 1024*1024);
+
+    memset(input, 0xA5, 16);
+
+    measureTimingBeginDeclared
+    if (buffered)
+        KangarooTwelve_InitializeBuffered(&kt, 32, stagingBuffer);
+    else
+        KangarooTwelve_Initialize(&kt, 32);
+    for(j=0; j<inputLen; j+=writeLen)
+        KangarooTwelve_Update(&kt, input+j, (inputLen-j < writeLen) ? (inputLen-j) : writeLen);
+    KangarooTwelve_Final(&kt, output, (const unsigned char *)"", 0);
+    measureTimingEnd
+}
+
+#define batchCount 64
+
+uint_32t measureKangarooTwelveBatch(uint_32t dtMin, unsigned int inputLen)
+{
+    ALIGN(32) static unsigned char input[batchCount][8192];
+    ALIGN(32) static unsigned char output[batchCount][32];
+    const unsigned char *inputs[batchCount];
+    unsigned char *outputs[batchCount];
+    size_t inputLens[batchCount];
+    measureTimingDeclare
+
+    assert(inputLen <= 8192);
+
+    for(i=0; i<batchCount; i++) {
+        memset(input[i], 0xA5 ^ i, 16);
+        inputs[i] = input[i];
+        outputs[i] = output[i];
+        inputLens[i] = inputLen;
+    }
+
+    measureTimingBeginDeclared
+    KangarooTwelve_Batch(inputs, inputLens, outputs, 32, batchCount, (const unsigned char *)"", 0);
+    measureTimingEnd
+}
+
+/* Larger than the last-level caches, so that its oldest slices have left them */
+#define coldBufferSize (256*1024*1024)
+
+uint_32t measureKangarooTwelveCache(uint_32t dtMin, const unsigned char *buffer, unsigned int inputLen, int cold)
+{
+    static size_t offset = 0;
+    const unsigned char *input = buffer;
+    ALIGN(32) unsigned char output[32];
+    measureTimingDeclare
+
+    assert(inputLen <= coldBufferSize/2);
+
+    measureTimingBeginDeclared
+    if (cold) {
+        /* Each measurement hashes the next slice, last touched a whole buffer ago */
+        offset = (offset + 2*inputLen <= coldBufferSize) ? offset + inputLen : 0;
+        input = buffer + offset;
+    }
+    KangarooTwelve(input, inputLen, output, 32, (const unsigned char *)"", 0);
+    measureTimingEnd
+}
+
 void printKangarooTwelvePerformanceHeader( void )
 {
     printf("*** KangarooTwelve ***\n");
     printf("Using Keccak-p[1600,12] implementations:\n");
-    printf("- \303\2271: " KeccakP1600_implementation "\n");
+    printf("- \303\2271: %s\n", KeccakP1600_implementation);
     #if defined(KeccakP1600_12rounds_FastLoop_supported)
     printf("      + KeccakP1600_12rounds_FastLoop_Absorb()\n");
     #endif
 
     #if defined(KeccakP1600times2_implementation) && !defined(KeccakP1600times2_isFallback)
-    printf("- \303\2272: " KeccakP1600times2_implementation "\n");
+    printf("- \303\2272: %s\n", KeccakP1600times2_implementation);
     #if defined(KeccakP1600times2_12rounds_FastLoop_supported)
     printf("      + KeccakP1600times2_12rounds_FastLoop_Absorb()\n");
     #endif
@@ -58,7 +130,7 @@ void printKangarooTwelvePerformanceHeader( void )
     #endif
 
     #if defined(KeccakP1600times4_implementation) && !defined(KeccakP1600times4_isFallback)
-    printf("- \303\2274: " KeccakP1600times4_implementation "\n");
+    printf("- \303\2274: %s\n", KeccakP1600times4_implementation);
     #if defined(KeccakP1600times4_12rounds_FastLoop_supported)
     printf("      + KeccakP1600times4_12rounds_FastLoop_Absorb()\n");
     #endif
@@ -67,7 +139,7 @@ void printKangarooTwelvePerformanceHeader( void )
     #endif
 
     #if defined(KeccakP1600times8_implementation) && !defined(KeccakP1600times8_isFallback)
-    printf("- \303\2278: " KeccakP1600times8_implementation "\n");
+    printf("- \303\2278: %s\n", KeccakP1600times8_implementation);
     #if defined(KeccakP1600times8_12rounds_FastLoop_supported)
     printf("      + KeccakP1600times8_12rounds_FastLoop_Absorb()\n");
     #endif
@@ -75,6 +147,15 @@ void printKangarooTwelvePerformanceHeader( void )
     printf("- \303\2278: not used\n");
     #endif
 
+    #if defined(KeccakP1600times16_implementation) && !defined(KeccakP1600times16_isFallback)
+    printf("- \303\22716: %s\n", KeccakP1600times16_implementation);
+    #if defined(KeccakP1600times16_12rounds_FastLoop_supported)
+    printf("      + KeccakP1600times16_12rounds_FastLoop_Absorb()\n");
+    #endif
+    #else
+    printf("- \303\22716: not used\n");
+    #endif
+
     printf("\n");
 }
 
@@ -90,7 +171,7 @@ void testKangarooTwelvePerformanceOne( void )
     for(halfTones=chunkSizeLog*12-28; halfTones<=13*12; halfTones+=4) {
         double I = pow(2.0, halfTones/12.0);
         unsigned int i  = (unsigned int)floor(I+0.5);
-        uint_32t time, timePlus1Block, timePlus2Blocks, timePlus4Blocks, timePlus8Blocks;
+        uint_32t time, timePlus1Block, timePlus2Blocks, timePlus4Blocks, timePlus8Blocks, timePlus16Blocks;
         uint_32t timePlus84Blocks;
         time = measureKangarooTwelve(calibration, i);
         if (i == chunkSize) {
@@ -99,6 +180,7 @@ void testKangarooTwelvePerformanceOne( void )
             timePlus2Blocks = measureKangarooTwelve(calibration, i+2*chunkSize);
             timePlus4Blocks = measureKangarooTwelve(calibration, i+4*chunkSize);
             timePlus8Blocks = measureKangarooTwelve(calibration, i+8*chunkSize);
+            timePlus16Blocks = measureKangarooTwelve(calibration, i+16*chunkSize);
             timePlus84Blocks = measureKangarooTwelve(calibration, i+84*chunkSize);
         }
         printf("%8d bytes: %9d cycles, %6.3f cycles/byte\n", i, time, time*1.0/i);
@@ -107,6 +189,7 @@ void testKangarooTwelvePerformanceOne( void )
             printf("     +2 blocks: %9d cycles, %6.3f cycles/byte (slope)\n", timePlus2Blocks, (timePlus2Blocks-(double)(time))*1.0/chunkSize/2.0);
             printf("     +4 blocks: %9d cycles, %6.3f cycles/byte (slope)\n", timePlus4Blocks, (timePlus4Blocks-(double)(time))*1.0/chunkSize/4.0);
             printf("     +8 blocks: %9d cycles, %6.3f cycles/byte (slope)\n", timePlus8Blocks, (timePlus8Blocks-(double)(time))*1.0/chunkSize/8.0);
+            printf("    +16 blocks: %9d cycles, %6.3f cycles/byte (slope)\n", timePlus16Blocks, (timePlus16Blocks-(double)(time))*1.0/chunkSize/16.0);
             printf("    +84 blocks: %9d cycles, %6.3f cycles/byte (slope)\n", timePlus84Blocks, (timePlus84Blocks-(double)(time))*1.0/chunkSize/84.0);
             displaySlope = 0;
         }
@@ -121,10 +204,70 @@ void testKangarooTwelvePerformanceOne( void )
     printf("\n\n");
 }
 
+void testKangarooTwelveBatchPerformance( void )
+{
+    const unsigned int inputLens[] = { 64, 128, 256, 512, 1024, 2048, 4096, 8189 };
+    uint_32t calibration = calibrate();
+    unsigned int i;
+
+    printf("KangarooTwelve_Batch() of %d messages, cycles per message:\n", batchCount);
+    measureKangarooTwelveBatch(calibration, 8189);
+    for(i=0; i<sizeof(inputLens)/sizeof(inputLens[0]); i++) {
+        uint_32t time = measureKangarooTwelveBatch(calibration, inputLens[i]);
+        printf("%8d bytes: %9d cycles, %6.3f cycles/byte\n", inputLens[i], time/batchCount, time*1.0/batchCount/inputLens[i]);
+    }
+    printf("\n\n");
+}
+
+void testKangarooTwelveStreamingPerformance( void )
+{
+    const unsigned int inputLen = 1024*1024;
+    const unsigned int writeLens[] = { 1500, 4096, 16384, 65536 };
+    uint_32t calibration = calibrate();
+    unsigned int i;
+
+    printf("KangarooTwelve_Update() of %d bytes in pieces, unbuffered and buffered:\n", inputLen);
+    measureKangarooTwelveStreaming(calibration, inputLen, inputLen, 0);
+    for(i=0; i<sizeof(writeLens)/sizeof(writeLens[0]); i++) {
+        uint_32t time = measureKangarooTwelveStreaming(calibration, inputLen, writeLens[i], 0);
+        uint_32t timeBuffered = measureKangarooTwelveStreaming(calibration, inputLen, writeLens[i], 1);
+        printf("%8d bytes per call: %6.3f cycles/byte, %6.3f cycles/byte buffered\n", writeLens[i], time*1.0/inputLen, timeBuffered*1.0/inputLen);
+    }
+    printf("\n\n");
+}
+
+void testKangarooTwelveCachePerformance( void )
+{
+    const unsigned int inputLens[] = { 65536, 1024*1024, 16*1024*1024 };
+    uint_32t calibration = calibrate();
+    unsigned char *buffer;
+    unsigned int i;
+
+    buffer = malloc(coldBufferSize);
+    if (buffer == NULL) {
+        printf("KangarooTwelve() on inputs in memory: not enough memory for the %d MiB buffer\n\n\n", coldBufferSize/1024/1024);
+        return;
+    }
+    memset(buffer, 0xA5, coldBufferSize);
+
+    printf("KangarooTwelve() on inputs in cache (hot) and in memory (cold, %d MiB buffer):\n", coldBufferSize/1024/1024);
+    measureKangarooTwelveCache(calibration, buffer, inputLens[0], 0);
+    for(i=0; i<sizeof(inputLens)/sizeof(inputLens[0]); i++) {
+        uint_32t time = measureKangarooTwelveCache(calibration, buffer, inputLens[i], 0);
+        uint_32t timeCold = measureKangarooTwelveCache(calibration, buffer, inputLens[i], 1);
+        printf("%8d bytes: %6.3f cycles/byte hot, %6.3f cycles/byte cold\n", inputLens[i], time*1.0/inputLens[i], timeCold*1.0/inputLens[i]);
+    }
+    printf("\n\n");
+    free(buffer);
+}
+
 void testKangarooTwelvePerformance()
 {
     printKangarooTwelvePerformanceHeader();
     testKangarooTwelvePerformanceOne();
+    testKangarooTwelveStreamingPerformance();
+    testKangarooTwelveCachePerformance();
+    testKangarooTwelveBatchPerformance();
 }
 void testPerformance()
 {
@@ -3,33 +3,24 @@ use std::path::PathBuf;
 use std::process::Command;
 
 fn target_name() -> &'static str {
-    #[cfg(any(target_arch = "x86", target_arch = "x86_64"))]
-    {
-        if is_x86_feature_detected!("avx512f") {
-            assert!(
-                is_x86_feature_detected!("avx512vl"),
-                "AVX-512F supported but not AVX-512VL. This isn't SkylakeX.",
-            );
-            return "SkylakeX";
-        } else if is_x86_feature_detected!("avx2") {
-            return "Haswell";
-        }
-    }
-    if std::mem::size_of::<usize>() == 8 {
+    // Use the target architecture rather than the build machine's, so that
+    // cross builds pick the right implementation.
+    let arch = env::var("CARGO_CFG_TARGET_ARCH").unwrap();
+    let pointer_width = env::var("CARGO_CFG_TARGET_POINTER_WIDTH").unwrap();
+    if arch == "x86_64" {
+        // One library for every x86-64 machine. It detects AVX2 and AVX-512
+        // at runtime.
+        "x86-64"
+    } else if pointer_width == "64" {
         "generic64"
-    } else if std::mem::size_of::<usize>() == 4 {
+    } else if pointer_width == "32" {
         "generic32"
     } else {
-        panic!("unexpected word size {}", std::mem::size_of::<usize>())
+        panic!("unexpected pointer width {}", pointer_width)
     }
 }
 
 fn main() {
-    // Do local CPU feature detection to determine which version to build. This
-    // wouldn't be correct if we were building a distributable binary, because
-    // the features of the target machine wouldn't necessarily be the same as
-    // the features of the build machine. But this build is just for
-    // benchmarks, so it's fine.
     let target = target_name();
     let manifest_dir: PathBuf = env::var("CARGO_MANIFEST_DIR").unwrap().into();
     let k12_dir = manifest_dir.join("K12");